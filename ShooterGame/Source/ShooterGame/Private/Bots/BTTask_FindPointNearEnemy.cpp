@@ -3,6 +3,7 @@
 #include "ShooterGame.h"
 #include "Bots/BTTask_FindPointNearEnemy.h"
 #include "Bots/ShooterAIController.h"
+#include "Bots/ShooterTacticalPointService.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyAllTypes.h"
@@ -26,6 +27,16 @@ EBTNodeResult::Type UBTTask_FindPointNearEnemy::ExecuteTask(UBehaviorTreeCompone
 	AShooterCharacter* Enemy = MyController->GetEnemy();
 	if (Enemy && MyBot)
 	{
+		// best scored position, shared with other bots fighting the same enemy
+		UShooterTacticalPointService* TacticalPoints = MyController->GetWorld()->GetSubsystem<UShooterTacticalPointService>();
+		FVector TacticalLoc;
+		if (TacticalPoints && TacticalPoints->FindPointNearEnemy(MyController, Enemy, TacticalLoc))
+		{
+			OwnerComp.GetBlackboardComponent()->SetValue<UBlackboardKeyType_Vector>(BlackboardKey.GetSelectedKeyID(), TacticalLoc);
+			return EBTNodeResult::Succeeded;
+		}
+
+		// points around this enemy aren't scored yet, take a random one in the meantime
 		const float SearchRadius = 200.0f;
 		const FVector SearchOrigin = Enemy->GetActorLocation() + 600.0f * (MyBot->GetActorLocation() - Enemy->GetActorLocation()).GetSafeNormal();
 		FVector Loc(0);
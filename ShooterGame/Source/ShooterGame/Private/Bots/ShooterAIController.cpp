@@ -10,14 +10,37 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
 #include "Weapons/ShooterWeapon.h"
+#include "Bots/ShooterPawnRegistry.h"
+#include "Bots/ShooterLOSService.h"
+#include "Bots/ShooterBehaviorTreeComponent.h"
+#include "Bots/ShooterPathCache.h"
+#include "Bots/ShooterTeamPerception.h"
+#include "Bots/ShooterAILODManager.h"
+
+static int32 BotEnemyLOSCandidates = 4;
+FAutoConsoleVariableRef CVarBotEnemyLOSCandidates(
+	TEXT("p.BotEnemyLOSCandidates"),
+	BotEnemyLOSCandidates,
+	TEXT("Closest enemies a bot traces to before falling back to every other enemy."),
+	ECVF_Default);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Enemy Scans"), STAT_ShooterBotEnemyScans, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Shared Enemy Picks"), STAT_ShooterBotSharedEnemyPicks, STATGROUP_Game);
 
 AShooterAIController::AShooterAIController(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
  	BlackboardComp = ObjectInitializer.CreateDefaultSubobject<UBlackboardComponent>(this, TEXT("BlackBoardComp"));
  	
-	BrainComponent = BehaviorComp = ObjectInitializer.CreateDefaultSubobject<UBehaviorTreeComponent>(this, TEXT("BehaviorComp"));	
+	BrainComponent = BehaviorComp = ObjectInitializer.CreateDefaultSubobject<UShooterBehaviorTreeComponent>(this, TEXT("BehaviorComp"));	
 
 	bWantsPlayerState = true;
+
+	AILODTier = EShooterAILOD::Engaged;
+	bAIUpdateGranted = true;
+	LastAIGrantTime = 0.f;
+	AIUpdateCostMs = 0.05f;
+	SkippedRotationTime = 0.f;
+	NextEnemyScanTime = 0.f;
 }
 
 void AShooterAIController::OnPossess(APawn* InPawn)
@@ -59,6 +82,33 @@ void AShooterAIController::BeginInactiveState()
 	GetWorldTimerManager().SetTimer(TimerHandle_Respawn, this, &AShooterAIController::Respawn, MinRespawnDelay);
 }
 
+void AShooterAIController::Reset()
+{
+	GetWorldTimerManager().ClearTimer(TimerHandle_Respawn);
+
+	StopMovement();
+	if (GetPawn())
+	{
+		UnPossess();
+	}
+	BehaviorComp->StopTree();
+
+	// InitializeBlackboard keeps values when possessing with the same asset
+	for (FBlackboard::FKey KeyID = 0; KeyID < BlackboardComp->GetNumKeys(); KeyID++)
+	{
+		BlackboardComp->ClearValue(KeyID);
+	}
+
+	// world time starts over in the next level
+	AILODTier = EShooterAILOD::Engaged;
+	bAIUpdateGranted = true;
+	LastAIGrantTime = 0.f;
+	SkippedRotationTime = 0.f;
+	NextEnemyScanTime = 0.f;
+
+	Super::Reset();
+}
+
 void AShooterAIController::Respawn()
 {
 	GetWorld()->GetAuthGameMode()->RestartPlayer(this);
@@ -67,31 +117,16 @@ void AShooterAIController::Respawn()
 void AShooterAIController::FindClosestEnemy()
 {
 	APawn* MyBot = GetPawn();
-	if (MyBot == NULL)
+	UShooterPawnRegistry* PawnRegistry = GetWorld()->GetSubsystem<UShooterPawnRegistry>();
+	if (MyBot == NULL || PawnRegistry == NULL)
 	{
 		return;
 	}
 
-	const FVector MyLoc = MyBot->GetActorLocation();
-	float BestDistSq = MAX_FLT;
-	AShooterCharacter* BestPawn = NULL;
-
-	for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(GetWorld()))
-	{
-		if (TestPawn->IsAlive() && TestPawn->IsEnemyFor(this))
-		{
-			const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-			if (DistSq < BestDistSq)
-			{
-				BestDistSq = DistSq;
-				BestPawn = TestPawn;
-			}
-		}
-	}
-
-	if (BestPawn)
+	TArray<AShooterCharacter*> Enemies;
+	if (PawnRegistry->FindNearestEnemies(this, MyBot->GetActorLocation(), 0.f, 1, Enemies) > 0)
 	{
-		SetEnemy(BestPawn);
+		SetEnemy(Enemies[0]);
 	}
 }
 
@@ -99,83 +134,93 @@ bool AShooterAIController::FindClosestEnemyWithLOS(AShooterCharacter* ExcludeEne
 {
 	bool bGotEnemy = false;
 	APawn* MyBot = GetPawn();
-	if (MyBot != NULL)
+	UShooterPawnRegistry* PawnRegistry = GetWorld()->GetSubsystem<UShooterPawnRegistry>();
+	if (MyBot != NULL && PawnRegistry != NULL)
 	{
-		const FVector MyLoc = MyBot->GetActorLocation();
-		float BestDistSq = MAX_FLT;
-		AShooterCharacter* BestPawn = NULL;
+		const int32 NumCandidates = FMath::Max(1, BotEnemyLOSCandidates);
 
-		for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(GetWorld()))
+		// enemies the team sees first, a teammate close by spares us the trace
+		UShooterTeamPerception* TeamPerception = GetWorld()->GetSubsystem<UShooterTeamPerception>();
+		TArray<FShooterPerceivedEnemy> KnownEnemies;
+		if (TeamPerception && TeamPerception->GetKnownEnemies(this, KnownEnemies))
 		{
-			if (TestPawn != ExcludeEnemy && TestPawn->IsAlive() && TestPawn->IsEnemyFor(this))
+			int32 NumTested = 0;
+			for (const FShooterPerceivedEnemy& Known : KnownEnemies)
 			{
-				if (HasWeaponLOSToEnemy(TestPawn, true) == true)
+				if (Known.Enemy == ExcludeEnemy)
+				{
+					continue;
+				}
+
+				if (Known.bTrusted)
 				{
-					const float DistSq = (TestPawn->GetActorLocation() - MyLoc).SizeSquared();
-					if (DistSq < BestDistSq)
-					{
-						BestDistSq = DistSq;
-						BestPawn = TestPawn;
-					}
+					INC_DWORD_STAT(STAT_ShooterBotSharedEnemyPicks);
+					SetEnemy(Known.Enemy);
+					return true;
+				}
+
+				if (NumTested++ < NumCandidates && HasWeaponLOSToEnemy(Known.Enemy, true))
+				{
+					SetEnemy(Known.Enemy);
+					return true;
 				}
 			}
+
+			// the team knows nothing we can use, look around ourselves now and then
+			const float TimeSeconds = GetWorld()->GetTimeSeconds();
+			if (TimeSeconds < NextEnemyScanTime)
+			{
+				return false;
+			}
+			NextEnemyScanTime = TimeSeconds + TeamPerception->GetScanInterval();
 		}
-		if (BestPawn)
-		{
-			SetEnemy(BestPawn);
-			bGotEnemy = true;
-		}
-	}
-	return bGotEnemy;
-}
 
-bool AShooterAIController::HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool bAnyEnemy) const
-{
-	
-	AShooterBot* MyBot = Cast<AShooterBot>(GetPawn());
+		INC_DWORD_STAT(STAT_ShooterBotEnemyScans);
 
-	bool bHasLOS = false;
-	// Perform trace to retrieve hit info
-	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(AIWeaponLosTrace), true, GetPawn());
-
-	TraceParams.bReturnPhysicalMaterial = true;	
-	FVector StartLocation = MyBot->GetActorLocation();	
-	StartLocation.Z += GetPawn()->BaseEyeHeight; //look from eyes
-	
-	FHitResult Hit(ForceInit);
-	const FVector EndLocation = InEnemyActor->GetActorLocation();
-	GetWorld()->LineTraceSingleByChannel(Hit, StartLocation, EndLocation, COLLISION_WEAPON, TraceParams);
-	if (Hit.bBlockingHit == true)
-	{
-		// Theres a blocking hit - check if its our enemy actor
-		AActor* HitActor = Hit.GetActor();
-		if (Hit.GetActor() != NULL)
+		const FVector MyLoc = MyBot->GetActorLocation();
+
+		// closest candidates first, the first one in sight is the closest visible enemy
+		TArray<AShooterCharacter*> Enemies;
+		PawnRegistry->FindNearestEnemies(this, MyLoc, 0.f, NumCandidates, Enemies, ExcludeEnemy);
+
+		int32 NumTested = 0;
+		for (int32 Pass = 0; Pass < 2 && !bGotEnemy; Pass++)
 		{
-			if (HitActor == InEnemyActor)
+			if (Pass == 1)
 			{
-				bHasLOS = true;
+				if (Enemies.Num() < NumCandidates)
+				{
+					// already saw every enemy
+					break;
+				}
+
+				// none of the closest ones is visible, try the rest
+				PawnRegistry->FindNearestEnemies(this, MyLoc, 0.f, 0, Enemies, ExcludeEnemy);
 			}
-			else if (bAnyEnemy == true)
+
+			for (int32 i = NumTested; i < Enemies.Num(); i++)
 			{
-				// Its not our actor, maybe its still an enemy ?
-				ACharacter* HitChar = Cast<ACharacter>(HitActor);
-				if (HitChar != NULL)
+				if (HasWeaponLOSToEnemy(Enemies[i], true) == true)
 				{
-					AShooterPlayerState* HitPlayerState = Cast<AShooterPlayerState>(HitChar->GetPlayerState());
-					AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(PlayerState);
-					if ((HitPlayerState != NULL) && (MyPlayerState != NULL))
-					{
-						if (HitPlayerState->GetTeamNum() != MyPlayerState->GetTeamNum())
-						{
-							bHasLOS = true;
-						}
-					}
+					SetEnemy(Enemies[i]);
+					bGotEnemy = true;
+					break;
 				}
 			}
+			NumTested = Enemies.Num();
 		}
 	}
+	return bGotEnemy;
+}
 
-	
+bool AShooterAIController::HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool bAnyEnemy) const
+{
+	bool bHasLOS = false;
+	if (InEnemyActor != NULL)
+	{
+		// last known result, refreshed asynchronously
+		UShooterLOSService::GetLOS(const_cast<AShooterAIController*>(this), InEnemyActor, InEnemyActor->GetActorLocation(), true, bAnyEnemy, bHasLOS);
+	}
 
 	return bHasLOS;
 }
@@ -193,7 +238,7 @@ void AShooterAIController::ShootEnemy()
 	AShooterCharacter* Enemy = GetEnemy();
 	if ( Enemy && ( Enemy->IsAlive() )&& (MyWeapon->GetCurrentAmmo() > 0) && ( MyWeapon->CanFire() == true ) )
 	{
-		if (LineOfSightTo(Enemy, MyBot->GetActorLocation()))
+		if (HasWeaponLOSToEnemy(Enemy, true))
 		{
 			bCanShoot = true;
 		}
@@ -243,6 +288,16 @@ class AShooterCharacter* AShooterAIController::GetEnemy() const
 
 void AShooterAIController::UpdateControlRotation(float DeltaTime, bool bUpdatePawn)
 {
+	// no human around to see it, follow the behavior tree slice
+	if (AILODTier >= EShooterAILOD::Idle && !bAIUpdateGranted)
+	{
+		SkippedRotationTime += DeltaTime;
+		return;
+	}
+
+	DeltaTime += SkippedRotationTime;
+	SkippedRotationTime = 0.f;
+
 	// Look toward focus
 	FVector FocalPoint = GetFocalPoint();
 	if( !FocalPoint.IsZero() && GetPawn())
@@ -263,6 +318,56 @@ void AShooterAIController::UpdateControlRotation(float DeltaTime, bool bUpdatePa
 	}
 }
 
+void AShooterAIController::FindPathForMoveRequest(const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath) const
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	UShooterPathCache* PathCache = GetWorld()->GetSubsystem<UShooterPathCache>();
+	FShooterPathCacheKey CacheKey;
+	if (PathCache && PathCache->FindPath(Query, CacheKey, OutPath))
+	{
+		// same setup AAIController does for a path it found
+		if (MoveRequest.IsMoveToActorRequest())
+		{
+			OutPath->SetGoalActorObservation(*MoveRequest.GetGoalActor(), 100.0f);
+		}
+		OutPath->EnableRecalculationOnInvalidation(true);
+	}
+	else
+	{
+		Super::FindPathForMoveRequest(MoveRequest, Query, OutPath);
+		if (PathCache && OutPath.IsValid())
+		{
+			PathCache->AddPath(CacheKey, Query, OutPath);
+		}
+	}
+
+	if (PathCache)
+	{
+		PathCache->AddPathfindingTime((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+}
+
+void AShooterAIController::SetAILOD(EShooterAILOD::Type NewTier, bool bGranted)
+{
+	AILODTier = NewTier;
+	bAIUpdateGranted = bGranted;
+	if (bGranted)
+	{
+		LastAIGrantTime = GetWorld()->GetTimeSeconds();
+	}
+}
+
+void AShooterAIController::OnAIUpdated(float CostMs)
+{
+	AIUpdateCostMs = FMath::Lerp(AIUpdateCostMs, CostMs, 0.2f);
+
+	if (UShooterAILODManager* AILODManager = GetWorld()->GetSubsystem<UShooterAILODManager>())
+	{
+		AILODManager->AddAIUpdateTime(CostMs);
+	}
+}
+
 void AShooterAIController::GameHasEnded(AActor* EndGameFocus, bool bIsWinner)
 {
 	// Stop the behaviour tree/logic
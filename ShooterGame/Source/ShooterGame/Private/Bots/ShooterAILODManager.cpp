@@ -0,0 +1,251 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterAILODManager.h"
+#include "Bots/ShooterAIController.h"
+#include "Bots/ShooterPawnRegistry.h"
+
+static int32 AILOD = 1;
+FAutoConsoleVariableRef CVarAILOD(
+	TEXT("p.AILOD"),
+	AILOD,
+	TEXT("Time slice bot behavior trees by LOD tier within p.AILODBudgetMs.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float AILODBudgetMs = 2.0f;
+FAutoConsoleVariableRef CVarAILODBudgetMs(
+	TEXT("p.AILODBudgetMs"),
+	AILODBudgetMs,
+	TEXT("Estimated milliseconds of behavior tree updates granted per frame."),
+	ECVF_Default);
+
+static float AILODMaxDelay = 0.75f;
+FAutoConsoleVariableRef CVarAILODMaxDelay(
+	TEXT("p.AILODMaxDelay"),
+	AILODMaxDelay,
+	TEXT("Bots waiting longer than this for an update get one regardless of the budget."),
+	ECVF_Default);
+
+static float AILODIntervals[EShooterAILOD::MAX] = { 0.f, 0.05f, 0.2f, 0.5f };
+FAutoConsoleVariableRef CVarAILODNearInterval(
+	TEXT("p.AILODNearInterval"),
+	AILODIntervals[EShooterAILOD::NearHumans],
+	TEXT("Behavior tree update interval of bots near human players."),
+	ECVF_Default);
+FAutoConsoleVariableRef CVarAILODIdleInterval(
+	TEXT("p.AILODIdleInterval"),
+	AILODIntervals[EShooterAILOD::Idle],
+	TEXT("Behavior tree update interval of bots that aren't fighting and have no human around."),
+	ECVF_Default);
+FAutoConsoleVariableRef CVarAILODFarInterval(
+	TEXT("p.AILODFarInterval"),
+	AILODIntervals[EShooterAILOD::Far],
+	TEXT("Behavior tree update interval of bots far from every human player."),
+	ECVF_Default);
+
+static float AILODCombatTime = 3.0f;
+FAutoConsoleVariableRef CVarAILODCombatTime(
+	TEXT("p.AILODCombatTime"),
+	AILODCombatTime,
+	TEXT("Seconds a bot stays engaged after firing or getting hit."),
+	ECVF_Default);
+
+static float AILODEngagedDistance = 3000.0f;
+FAutoConsoleVariableRef CVarAILODEngagedDistance(
+	TEXT("p.AILODEngagedDistance"),
+	AILODEngagedDistance,
+	TEXT("Bots with an enemy closer than this are engaged."),
+	ECVF_Default);
+
+static float AILODNearDistance = 5000.0f;
+FAutoConsoleVariableRef CVarAILODNearDistance(
+	TEXT("p.AILODNearDistance"),
+	AILODNearDistance,
+	TEXT("Bots closer than this to a human player are near."),
+	ECVF_Default);
+
+static float AILODFarDistance = 10000.0f;
+FAutoConsoleVariableRef CVarAILODFarDistance(
+	TEXT("p.AILODFarDistance"),
+	AILODFarDistance,
+	TEXT("Bots further than this from every human player are far."),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots Engaged"), STAT_ShooterBotsEngaged, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots Near Humans"), STAT_ShooterBotsNearHumans, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots Idle"), STAT_ShooterBotsIdle, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots Far"), STAT_ShooterBotsFar, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bot Updates Granted"), STAT_ShooterBotUpdatesGranted, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bot Updates Starving"), STAT_ShooterBotUpdatesStarving, STATGROUP_Game);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Bot Updates Estimated Ms"), STAT_ShooterBotUpdatesEstimatedMs, STATGROUP_Game);
+
+void UShooterAILODManager::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterAILODManager_Tick);
+
+	UWorld* World = GetWorld();
+
+	LastFrameAIUpdateMs = FrameAIUpdateMs;
+	FrameAIUpdateMs = 0.f;
+
+	if (!AILOD)
+	{
+		if (bHasThrottledBots)
+		{
+			bHasThrottledBots = false;
+			for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+			{
+				if (AShooterAIController* Controller = Cast<AShooterAIController>(It->Get()))
+				{
+					Controller->SetAILOD(EShooterAILOD::Engaged, true);
+				}
+			}
+		}
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<8>> HumanLocations;
+	if (UShooterPawnRegistry* PawnRegistry = World->GetSubsystem<UShooterPawnRegistry>())
+	{
+		for (const FShooterPawnEntry& Entry : PawnRegistry->GetPawns())
+		{
+			if (Entry.Pawn->IsPlayerControlled())
+			{
+				HumanLocations.Add(Entry.Location);
+			}
+		}
+	}
+
+	const float TimeSeconds = World->GetTimeSeconds();
+	int32 NumPerTier[EShooterAILOD::MAX] = { 0, 0, 0, 0 };
+
+	TArray<FAILODCandidate, TInlineAllocator<64>> Candidates;
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		AShooterAIController* Controller = Cast<AShooterAIController>(It->Get());
+		if (Controller == nullptr)
+		{
+			continue;
+		}
+
+		const EShooterAILOD::Type Tier = CalcTier(Controller, HumanLocations);
+		NumPerTier[Tier]++;
+
+		// granted updates run next frame
+		const float Interval = AILODIntervals[Tier];
+		const float Waited = TimeSeconds + DeltaTime - Controller->GetLastAIGrantTime();
+		if (Waited < Interval)
+		{
+			Controller->SetAILOD(Tier, false);
+			bHasThrottledBots = true;
+			continue;
+		}
+
+		FAILODCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+		Candidate.Controller = Controller;
+		Candidate.Tier = Tier;
+		Candidate.Priority = Waited / FMath::Max(Interval, 0.01f);
+		Candidate.bStarving = Waited >= AILODMaxDelay;
+	}
+
+	// starving first, then by tier, then most overdue
+	Candidates.Sort([](const FAILODCandidate& A, const FAILODCandidate& B)
+	{
+		if (A.bStarving != B.bStarving)
+		{
+			return A.bStarving;
+		}
+		if (A.Tier != B.Tier)
+		{
+			return A.Tier < B.Tier;
+		}
+		return A.Priority > B.Priority;
+	});
+
+	float SpentMs = 0.f;
+	int32 NumGranted = 0;
+	int32 NumStarving = 0;
+	for (const FAILODCandidate& Candidate : Candidates)
+	{
+		const float CostMs = Candidate.Controller->GetAIUpdateCost();
+		const bool bGranted = Candidate.bStarving || SpentMs + CostMs <= AILODBudgetMs;
+		if (bGranted)
+		{
+			SpentMs += CostMs;
+			NumGranted++;
+			NumStarving += Candidate.bStarving ? 1 : 0;
+		}
+		else
+		{
+			bHasThrottledBots = true;
+		}
+
+		Candidate.Controller->SetAILOD(Candidate.Tier, bGranted);
+	}
+
+	SET_DWORD_STAT(STAT_ShooterBotsEngaged, NumPerTier[EShooterAILOD::Engaged]);
+	SET_DWORD_STAT(STAT_ShooterBotsNearHumans, NumPerTier[EShooterAILOD::NearHumans]);
+	SET_DWORD_STAT(STAT_ShooterBotsIdle, NumPerTier[EShooterAILOD::Idle]);
+	SET_DWORD_STAT(STAT_ShooterBotsFar, NumPerTier[EShooterAILOD::Far]);
+	SET_DWORD_STAT(STAT_ShooterBotUpdatesGranted, NumGranted);
+	SET_DWORD_STAT(STAT_ShooterBotUpdatesStarving, NumStarving);
+	SET_FLOAT_STAT(STAT_ShooterBotUpdatesEstimatedMs, SpentMs);
+}
+
+EShooterAILOD::Type UShooterAILODManager::CalcTier(const AShooterAIController* Controller, const TArray<FVector, TInlineAllocator<8>>& HumanLocations) const
+{
+	const AShooterCharacter* MyPawn = Cast<AShooterCharacter>(Controller->GetPawn());
+	if (MyPawn == nullptr)
+	{
+		// waiting for respawn
+		return EShooterAILOD::Far;
+	}
+
+	const FVector Location = MyPawn->GetActorLocation();
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	if (MyPawn->GetLastCombatTime() > 0.f && TimeSeconds - MyPawn->GetLastCombatTime() < AILODCombatTime)
+	{
+		return EShooterAILOD::Engaged;
+	}
+
+	const AShooterCharacter* Enemy = Controller->GetEnemy();
+	if (Enemy && FVector::DistSquared(Enemy->GetActorLocation(), Location) < FMath::Square(AILODEngagedDistance))
+	{
+		return EShooterAILOD::Engaged;
+	}
+
+	float MinDistanceSq = MAX_flt;
+	for (const FVector& HumanLocation : HumanLocations)
+	{
+		MinDistanceSq = FMath::Min(MinDistanceSq, FVector::DistSquared(HumanLocation, Location));
+	}
+
+	if (MinDistanceSq < FMath::Square(AILODNearDistance))
+	{
+		return EShooterAILOD::NearHumans;
+	}
+
+	return MinDistanceSq > FMath::Square(AILODFarDistance) ? EShooterAILOD::Far : EShooterAILOD::Idle;
+}
+
+bool UShooterAILODManager::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client;
+}
+
+ETickableTickType UShooterAILODManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterAILODManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterAILODManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterAILODManager, STATGROUP_Tickables);
+}
@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterBehaviorTreeComponent.h"
+#include "Bots/ShooterAIController.h"
+
+UShooterBehaviorTreeComponent::UShooterBehaviorTreeComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SkippedDeltaTime = 0.f;
+}
+
+void UShooterBehaviorTreeComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	AShooterAIController* MyController = Cast<AShooterAIController>(GetOwner());
+	if (MyController && !MyController->IsAIUpdateGranted())
+	{
+		SkippedDeltaTime += DeltaTime;
+		return;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	Super::TickComponent(DeltaTime + SkippedDeltaTime, TickType, ThisTickFunction);
+	SkippedDeltaTime = 0.f;
+
+	if (MyController)
+	{
+		MyController->OnAIUpdated(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+	}
+}
@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterBotManager.h"
+#include "Bots/ShooterAIController.h"
+
+static int32 BotSpawnStagger = 1;
+FAutoConsoleVariableRef CVarBotSpawnStagger(
+	TEXT("p.BotSpawnStagger"),
+	BotSpawnStagger,
+	TEXT("Spread bot creation and spawns over frames within p.BotSpawnBudgetMs.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float BotSpawnBudgetMs = 2.0f;
+FAutoConsoleVariableRef CVarBotSpawnBudgetMs(
+	TEXT("p.BotSpawnBudgetMs"),
+	BotSpawnBudgetMs,
+	TEXT("Milliseconds per frame spent creating and spawning bots, at least one bot is handled each frame."),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bot Spawn Queue"), STAT_ShooterBotSpawnQueue, STATGROUP_Game);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Match Start Worst Frame Ms"), STAT_ShooterMatchStartWorstFrameMs, STATGROUP_Game);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Match Start Bot Work Ms"), STAT_ShooterMatchStartBotWorkMs, STATGROUP_Game);
+
+void UShooterBotManager::QueueBotCreation(int32 BotNum)
+{
+	FBotSpawnRequest& Request = Queue.AddDefaulted_GetRef();
+	Request.BotNum = BotNum;
+}
+
+void UShooterBotManager::QueueBotStart(AShooterAIController* Controller)
+{
+	FBotSpawnRequest& Request = Queue.AddDefaulted_GetRef();
+	Request.Controller = Controller;
+	Request.BotNum = INDEX_NONE;
+}
+
+void UShooterBotManager::BeginMatchStart()
+{
+	bMeasuringMatchStart = true;
+	MatchStartFrame = GFrameCounter;
+	MatchStartTime = FPlatformTime::Seconds();
+	MatchStartNumBots = 0;
+	MatchStartWorkMs = 0.f;
+	MatchStartWorstFrameMs = 0.f;
+}
+
+void UShooterBotManager::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterBotManager_Tick);
+
+	// tickables run after timers, delta of the frame match start began in shows up next frame
+	if (bMeasuringMatchStart && GFrameCounter > MatchStartFrame)
+	{
+		MatchStartWorstFrameMs = FMath::Max(MatchStartWorstFrameMs, static_cast<float>(FApp::GetDeltaTime() * 1000.0));
+		if (GetNumQueued() == 0)
+		{
+			EndMatchStart();
+		}
+	}
+
+	if (GetNumQueued() > 0)
+	{
+		ProcessQueue();
+	}
+
+	SET_DWORD_STAT(STAT_ShooterBotSpawnQueue, GetNumQueued());
+}
+
+void UShooterBotManager::ProcessQueue()
+{
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode == nullptr)
+	{
+		Queue.Reset();
+		QueueHead = 0;
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = BotSpawnStagger ? BotSpawnBudgetMs / 1000.0 : MAX_dbl;
+
+	int32 NumProcessed = 0;
+	while (QueueHead < Queue.Num() && (NumProcessed == 0 || FPlatformTime::Seconds() - StartTime < BudgetSeconds))
+	{
+		const FBotSpawnRequest Request = Queue[QueueHead++];
+		NumProcessed++;
+
+		if (Request.BotNum != INDEX_NONE)
+		{
+			AShooterAIController* NewController = GameMode->CreateBot(Request.BotNum);
+
+			// created after StartBots, spawn it like the others
+			if (NewController && GameMode->IsMatchInProgress())
+			{
+				QueueBotStart(NewController);
+			}
+			continue;
+		}
+
+		// may have been spawned by its respawn timer meanwhile
+		AShooterAIController* Controller = Request.Controller.Get();
+		if (Controller && Controller->GetPawn() == nullptr && GameMode->IsMatchInProgress())
+		{
+			GameMode->RestartPlayer(Controller);
+			MatchStartNumBots++;
+		}
+	}
+
+	if (QueueHead >= Queue.Num())
+	{
+		Queue.Reset();
+		QueueHead = 0;
+	}
+
+	if (bMeasuringMatchStart)
+	{
+		MatchStartWorkMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	}
+}
+
+void UShooterBotManager::EndMatchStart()
+{
+	bMeasuringMatchStart = false;
+	LastMatchStartWorstFrameMs = MatchStartWorstFrameMs;
+
+	SET_FLOAT_STAT(STAT_ShooterMatchStartWorstFrameMs, MatchStartWorstFrameMs);
+	SET_FLOAT_STAT(STAT_ShooterMatchStartBotWorkMs, MatchStartWorkMs);
+
+	UE_LOG(LogShooter, Log, TEXT("Match start: %d bots over %d frames (%.1f ms), %.2f ms of bot work, worst frame %.2f ms"),
+		MatchStartNumBots, static_cast<int32>(GFrameCounter - MatchStartFrame), (FPlatformTime::Seconds() - MatchStartTime) * 1000.0,
+		MatchStartWorkMs, MatchStartWorstFrameMs);
+}
+
+bool UShooterBotManager::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client;
+}
+
+ETickableTickType UShooterBotManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterBotManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterBotManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterBotManager, STATGROUP_Tickables);
+}
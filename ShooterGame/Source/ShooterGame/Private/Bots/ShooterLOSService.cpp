@@ -0,0 +1,271 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterLOSService.h"
+#include "Bots/ShooterTeamPerception.h"
+#include "Online/ShooterPlayerState.h"
+
+static int32 AsyncAILOS = 1;
+FAutoConsoleVariableRef CVarAsyncAILOS(
+	TEXT("p.AsyncAILOS"),
+	AsyncAILOS,
+	TEXT("Trace bot line of sight asynchronously, results are one frame old.\n")
+	TEXT("0: Trace on request, 1: Enable"),
+	ECVF_Default);
+
+static float AILOSRefreshInterval = 0.1f;
+FAutoConsoleVariableRef CVarAILOSRefreshInterval(
+	TEXT("p.AILOSRefreshInterval"),
+	AILOSRefreshInterval,
+	TEXT("Min seconds between two traces of the same bot and target. 0: every frame it's asked for"),
+	ECVF_Default);
+
+static float AILOSForgetTime = 1.0f;
+FAutoConsoleVariableRef CVarAILOSForgetTime(
+	TEXT("p.AILOSForgetTime"),
+	AILOSForgetTime,
+	TEXT("Bot and target pairs not asked for this long are forgotten."),
+	ECVF_Default);
+
+/** location targets closer than this share a result */
+static const float LOSLocationQuantization = 50.0f;
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOS Requests"), STAT_ShooterAILOSRequests, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOS Misses"), STAT_ShooterAILOSMisses, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOS Async Traces"), STAT_ShooterAILOSAsyncTraces, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOS Sync Traces"), STAT_ShooterAILOSSyncTraces, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI LOS Pairs"), STAT_ShooterAILOSPairs, STATGROUP_Game);
+
+bool UShooterLOSService::GetLOS(AController* Querier, AActor* TargetActor, const FVector& TargetLocation, bool bFromEyes, bool bAnyEnemy, bool& bOutHasLOS, float* OutAge)
+{
+	bOutHasLOS = false;
+
+	UWorld* World = Querier ? Querier->GetWorld() : nullptr;
+	UShooterLOSService* LOSService = World ? World->GetSubsystem<UShooterLOSService>() : nullptr;
+	if (LOSService == nullptr)
+	{
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_ShooterAILOSRequests);
+
+	FShooterLOSKey Key;
+	Key.Querier = Querier;
+	Key.Target = TargetActor;
+	Key.bFromEyes = bFromEyes;
+	Key.bAnyEnemy = bAnyEnemy;
+	if (TargetActor == nullptr)
+	{
+		Key.TargetCell = FIntVector(
+			FMath::RoundToInt(TargetLocation.X / LOSLocationQuantization),
+			FMath::RoundToInt(TargetLocation.Y / LOSLocationQuantization),
+			FMath::RoundToInt(TargetLocation.Z / LOSLocationQuantization));
+	}
+
+	const float TimeSeconds = World->GetTimeSeconds();
+
+	FShooterLOSEntry& Entry = LOSService->Entries.FindOrAdd(Key);
+	Entry.TargetLocation = TargetActor ? TargetActor->GetActorLocation() : TargetLocation;
+	Entry.LastRequestTime = TimeSeconds;
+	Entry.bRequested = true;
+
+	if (!AsyncAILOS && !(Entry.bHasResult && Entry.ResultTime == TimeSeconds))
+	{
+		FVector TraceStart;
+		FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(AILosTrace), true);
+		FHitResult Hit(ForceInit);
+		const bool bTraced = LOSService->GetTraceStart(Key, TraceStart, TraceParams)
+			&& World->LineTraceSingleByChannel(Hit, TraceStart, Entry.TargetLocation, COLLISION_WEAPON, TraceParams);
+
+		Entry.bHasLOS = bTraced && LOSService->EvaluateHit(Key, TraceStart, Entry.TargetLocation, &Hit);
+		Entry.bHasResult = true;
+		Entry.ResultTime = TimeSeconds;
+		INC_DWORD_STAT(STAT_ShooterAILOSSyncTraces);
+		LOSService->NumTraces++;
+
+		// report what the trace actually saw, with bAnyEnemy that may be another enemy in front of the target
+		if (Entry.bHasLOS)
+		{
+			UShooterTeamPerception::ReportSighting(Querier, Hit.GetActor());
+		}
+	}
+
+	if (!Entry.bHasResult)
+	{
+		INC_DWORD_STAT(STAT_ShooterAILOSMisses);
+		return false;
+	}
+
+	bOutHasLOS = Entry.bHasLOS;
+	if (OutAge)
+	{
+		*OutAge = TimeSeconds - Entry.ResultTime;
+	}
+
+	return true;
+}
+
+void UShooterLOSService::Tick(float DeltaTime)
+{
+	DispatchTraces();
+}
+
+void UShooterLOSService::DispatchTraces()
+{
+	UWorld* World = GetWorld();
+	const float TimeSeconds = World->GetTimeSeconds();
+
+	if (!TraceDelegate.IsBound())
+	{
+		TraceDelegate.BindUObject(this, &UShooterLOSService::OnTraceCompleted);
+	}
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		const FShooterLOSKey& Key = It.Key();
+		FShooterLOSEntry& Entry = It.Value();
+
+		if (!Key.Querier.IsValid() || (!Key.Target.IsExplicitlyNull() && !Key.Target.IsValid())
+			|| TimeSeconds - Entry.LastRequestTime > AILOSForgetTime)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (!Entry.bRequested || Entry.PendingTraceId != 0 || !AsyncAILOS)
+		{
+			continue;
+		}
+
+		Entry.bRequested = false;
+		if (Entry.bHasResult && TimeSeconds - Entry.ResultTime < AILOSRefreshInterval)
+		{
+			continue;
+		}
+
+		FVector TraceStart;
+		FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(AILosTrace), true);
+		if (!GetTraceStart(Key, TraceStart, TraceParams))
+		{
+			Entry.bHasLOS = false;
+			Entry.bHasResult = true;
+			Entry.ResultTime = TimeSeconds;
+			continue;
+		}
+
+		const FVector TraceEnd = Key.Target.IsValid() ? Key.Target->GetActorLocation() : Entry.TargetLocation;
+
+		// 0 marks an idle entry
+		LastTraceId = FMath::Max(LastTraceId + 1, 1u);
+		Entry.PendingTraceId = LastTraceId;
+		PendingTraces.Add(LastTraceId, Key);
+
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, COLLISION_WEAPON, TraceParams,
+			FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, LastTraceId);
+		INC_DWORD_STAT(STAT_ShooterAILOSAsyncTraces);
+		NumTraces++;
+	}
+
+	SET_DWORD_STAT(STAT_ShooterAILOSPairs, Entries.Num());
+}
+
+bool UShooterLOSService::GetTraceStart(const FShooterLOSKey& Key, FVector& OutStart, FCollisionQueryParams& OutParams) const
+{
+	AController* Querier = Key.Querier.Get();
+	APawn* MyPawn = Querier ? Querier->GetPawn() : nullptr;
+	if (MyPawn == nullptr)
+	{
+		return false;
+	}
+
+	OutStart = MyPawn->GetActorLocation();
+	if (Key.bFromEyes)
+	{
+		OutStart.Z += MyPawn->BaseEyeHeight;
+	}
+
+	OutParams.bReturnPhysicalMaterial = true;
+	OutParams.AddIgnoredActor(MyPawn);
+	OutParams.AddIgnoredActor(Querier);
+	return true;
+}
+
+bool UShooterLOSService::EvaluateHit(const FShooterLOSKey& Key, const FVector& TraceStart, const FVector& TargetLocation, const FHitResult* Hit) const
+{
+	if (Hit == nullptr || !Hit->bBlockingHit)
+	{
+		return false;
+	}
+
+	AActor* HitActor = Hit->GetActor();
+	if (HitActor == nullptr)
+	{
+		// location target, LOS if what we hit is further away than the target
+		return Key.Target.IsExplicitlyNull() && (TargetLocation - TraceStart).SizeSquared() < (Hit->ImpactPoint - TraceStart).SizeSquared();
+	}
+
+	if (HitActor == Key.Target.Get())
+	{
+		return true;
+	}
+
+	if (Key.bAnyEnemy)
+	{
+		// not our target, maybe it's still an enemy?
+		const ACharacter* HitChar = Cast<ACharacter>(HitActor);
+		const AShooterPlayerState* HitPlayerState = HitChar ? Cast<AShooterPlayerState>(HitChar->GetPlayerState()) : nullptr;
+		const AShooterPlayerState* MyPlayerState = Key.Querier.IsValid() ? Cast<AShooterPlayerState>(Key.Querier->PlayerState) : nullptr;
+		if (HitPlayerState && MyPlayerState && HitPlayerState->GetTeamNum() != MyPlayerState->GetTeamNum())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UShooterLOSService::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FShooterLOSKey Key;
+	if (!PendingTraces.RemoveAndCopyValue(Datum.UserData, Key))
+	{
+		return;
+	}
+
+	FShooterLOSEntry* Entry = Entries.Find(Key);
+	if (Entry == nullptr || Entry->PendingTraceId != Datum.UserData)
+	{
+		return;
+	}
+
+	Entry->PendingTraceId = 0;
+	Entry->bHasLOS = EvaluateHit(Key, Datum.Start, Datum.End, Datum.OutHits.Num() > 0 ? &Datum.OutHits[0] : nullptr);
+	Entry->bHasResult = true;
+	Entry->ResultTime = GetWorld()->GetTimeSeconds();
+
+	// teammates of the querier get to know the pawn that was seen, which isn't always the target with bAnyEnemy
+	if (Entry->bHasLOS)
+	{
+		UShooterTeamPerception::ReportSighting(Key.Querier.Get(), Datum.OutHits[0].GetActor());
+	}
+}
+
+bool UShooterLOSService::IsTickable() const
+{
+	return Entries.Num() > 0;
+}
+
+ETickableTickType UShooterLOSService::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterLOSService::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterLOSService::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterLOSService, STATGROUP_Tickables);
+}
@@ -0,0 +1,269 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterPathCache.h"
+#include "NavMesh/NavMeshPath.h"
+
+static int32 PathCache = 1;
+FAutoConsoleVariableRef CVarPathCache(
+	TEXT("p.PathCache"),
+	PathCache,
+	TEXT("Reuse paths of bot move requests with close endpoints.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float PathCacheCellSize = 200.0f;
+FAutoConsoleVariableRef CVarPathCacheCellSize(
+	TEXT("p.PathCacheCellSize"),
+	PathCacheCellSize,
+	TEXT("Endpoints are quantized to cells of this size, on top of their navmesh poly."),
+	ECVF_Default);
+
+static float PathCacheLifetime = 5.0f;
+FAutoConsoleVariableRef CVarPathCacheLifetime(
+	TEXT("p.PathCacheLifetime"),
+	PathCacheLifetime,
+	TEXT("Seconds a cached path is reused for."),
+	ECVF_Default);
+
+static int32 PathCacheSize = 256;
+FAutoConsoleVariableRef CVarPathCacheSize(
+	TEXT("p.PathCacheSize"),
+	PathCacheSize,
+	TEXT("Max cached paths."),
+	ECVF_Default);
+
+static float PathCoalesceRadius = 200.0f;
+FAutoConsoleVariableRef CVarPathCoalesceRadius(
+	TEXT("p.PathCoalesceRadius"),
+	PathCoalesceRadius,
+	TEXT("Requests with both endpoints this close to a path found in the same frame reuse it."),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cached Paths"), STAT_ShooterCachedPaths, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Cache Hits"), STAT_ShooterPathCacheHits, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Requests Coalesced"), STAT_ShooterPathRequestsCoalesced, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Cache Misses"), STAT_ShooterPathCacheMisses, STATGROUP_Game);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Pathfinding Ms Per Second"), STAT_ShooterPathfindingMsPerSecond, STATGROUP_Game);
+
+bool UShooterPathCache::FindPath(const FPathFindingQuery& Query, FShooterPathCacheKey& OutKey, FNavPathSharedPtr& OutPath)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterPathCache_FindPath);
+
+	OutKey = FShooterPathCacheKey();
+	if (!PathCache)
+	{
+		return false;
+	}
+
+	OutKey = MakeKey(Query);
+	if (!OutKey.IsValid())
+	{
+		return false;
+	}
+
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	if (const FShooterPathCacheEntry* Entry = Entries.Find(OutKey))
+	{
+		if (IsEntryValid(*Entry, TimeSeconds))
+		{
+			if (CanReusePath(*Entry, OutKey, Query))
+			{
+				OutPath = CopyPath(Entry->Path, OutKey, Query);
+				INC_DWORD_STAT(STAT_ShooterPathCacheHits);
+				return true;
+			}
+		}
+		else
+		{
+			Entries.Remove(OutKey);
+		}
+	}
+
+	// merge with paths found this frame, their endpoints are in other polys or cells
+	if (FrameKeysFrame == GFrameCounter)
+	{
+		const float CoalesceRadiusSq = FMath::Square(PathCoalesceRadius);
+		for (const FShooterPathCacheKey& FrameKey : FrameKeys)
+		{
+			const FShooterPathCacheEntry* Entry = Entries.Find(FrameKey);
+			if (Entry == nullptr || FrameKey.NavData != OutKey.NavData || FrameKey.QueryFilter != OutKey.QueryFilter
+				|| FVector::DistSquared(Entry->StartLocation, OutKey.Start.Location) > CoalesceRadiusSq
+				|| FVector::DistSquared(Entry->GoalLocation, OutKey.Goal.Location) > CoalesceRadiusSq
+				|| !IsEntryValid(*Entry, TimeSeconds))
+			{
+				continue;
+			}
+
+			if (CanReusePath(*Entry, OutKey, Query))
+			{
+				OutPath = CopyPath(Entry->Path, OutKey, Query);
+				INC_DWORD_STAT(STAT_ShooterPathRequestsCoalesced);
+				return true;
+			}
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ShooterPathCacheMisses);
+	return false;
+}
+
+void UShooterPathCache::AddPath(const FShooterPathCacheKey& Key, const FPathFindingQuery& Query, const FNavPathSharedPtr& Path)
+{
+	// partial paths depend on where the search gave up, don't hand them out
+	if (!Key.IsValid() || !Path.IsValid() || !Path->IsValid() || Path->IsPartial())
+	{
+		return;
+	}
+
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	if (Entries.Num() >= PathCacheSize)
+	{
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (!IsEntryValid(It.Value(), TimeSeconds))
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		while (Entries.Num() > 0 && Entries.Num() >= PathCacheSize)
+		{
+			auto OldestIt = Entries.CreateIterator();
+			for (auto It = Entries.CreateIterator(); It; ++It)
+			{
+				if (It.Value().Time < OldestIt.Value().Time)
+				{
+					OldestIt = It;
+				}
+			}
+			OldestIt.RemoveCurrent();
+		}
+	}
+
+	// the requester keeps updating its own path, cache a copy that only gets invalidated by navmesh changes
+	FShooterPathCacheEntry& Entry = Entries.Add(Key);
+	Entry.Path = CopyPath(Path, Key, Query);
+	Entry.StartLocation = Key.Start.Location;
+	Entry.GoalLocation = Key.Goal.Location;
+	Entry.Time = TimeSeconds;
+
+	if (FrameKeysFrame != GFrameCounter)
+	{
+		FrameKeysFrame = GFrameCounter;
+		FrameKeys.Reset();
+	}
+	FrameKeys.Add(Key);
+
+	SET_DWORD_STAT(STAT_ShooterCachedPaths, Entries.Num());
+}
+
+void UShooterPathCache::AddPathfindingTime(float Ms)
+{
+	WindowPathfindingMs += Ms;
+
+	const double Now = FPlatformTime::Seconds();
+	if (WindowStartTime == 0.0)
+	{
+		WindowStartTime = Now;
+	}
+	else if (Now - WindowStartTime >= 1.0)
+	{
+		PathfindingMsPerSecond = WindowPathfindingMs / (Now - WindowStartTime);
+		SET_FLOAT_STAT(STAT_ShooterPathfindingMsPerSecond, PathfindingMsPerSecond);
+
+		WindowPathfindingMs = 0.f;
+		WindowStartTime = Now;
+	}
+}
+
+FShooterPathCacheKey UShooterPathCache::MakeKey(const FPathFindingQuery& Query) const
+{
+	FShooterPathCacheKey Key;
+
+	const ANavigationData* NavData = Query.NavData.Get();
+	if (NavData == nullptr)
+	{
+		return Key;
+	}
+
+	const UObject* Querier = Query.Owner.Get();
+	const FVector Extent = NavData->GetConfig().DefaultQueryExtent;
+	if (!NavData->ProjectPoint(Query.StartLocation, Key.Start, Extent, Query.QueryFilter, Querier)
+		|| !NavData->ProjectPoint(Query.EndLocation, Key.Goal, Extent, Query.QueryFilter, Querier))
+	{
+		return Key;
+	}
+
+	const float CellSize = FMath::Max(1.0f, PathCacheCellSize);
+	Key.NavData = NavData;
+	Key.QueryFilter = Query.QueryFilter.Get();
+	Key.StartPoly = Key.Start.NodeRef;
+	Key.GoalPoly = Key.Goal.NodeRef;
+	Key.StartCell = FIntVector(FMath::FloorToInt(Key.Start.Location.X / CellSize), FMath::FloorToInt(Key.Start.Location.Y / CellSize), FMath::FloorToInt(Key.Start.Location.Z / CellSize));
+	Key.GoalCell = FIntVector(FMath::FloorToInt(Key.Goal.Location.X / CellSize), FMath::FloorToInt(Key.Goal.Location.Y / CellSize), FMath::FloorToInt(Key.Goal.Location.Z / CellSize));
+	return Key;
+}
+
+bool UShooterPathCache::CanReusePath(const FShooterPathCacheEntry& Entry, const FShooterPathCacheKey& Key, const FPathFindingQuery& Query) const
+{
+	const TArray<FNavPathPoint>& Points = Entry.Path->GetPathPoints();
+	const int32 NumPoints = Points.Num();
+	if (NumPoints < 2)
+	{
+		return false;
+	}
+
+	// new endpoints have to see the inner points of the path on the navmesh
+	FVector HitLocation;
+	const FVector FirstTarget = (NumPoints > 2) ? Points[1].Location : Key.Goal.Location;
+	if (Key.NavData->Raycast(Key.Start.Location, FirstTarget, HitLocation, Query.QueryFilter, Query.Owner.Get()))
+	{
+		return false;
+	}
+
+	return NumPoints == 2 || !Key.NavData->Raycast(Points[NumPoints - 2].Location, Key.Goal.Location, HitLocation, Query.QueryFilter, Query.Owner.Get());
+}
+
+FNavPathSharedPtr UShooterPathCache::CopyPath(const FNavPathSharedPtr& Source, const FShooterPathCacheKey& Key, const FPathFindingQuery& Query) const
+{
+	const TArray<FNavPathPoint>& SourcePoints = Source->GetPathPoints();
+	const FNavMeshPath* SourceNavMeshPath = Source->CastPath<FNavMeshPath>();
+	FNavPathSharedPtr NewPath = SourceNavMeshPath ? Key.NavData->CreatePathInstance<FNavMeshPath>(Query) : Key.NavData->CreatePathInstance<FNavigationPath>(Query);
+
+	TArray<FNavPathPoint>& NewPoints = NewPath->GetPathPoints();
+	NewPoints = SourcePoints;
+	NewPoints[0] = FNavPathPoint(Key.Start.Location, Key.Start.NodeRef, SourcePoints[0].Flags);
+	NewPoints.Last() = FNavPathPoint(Key.Goal.Location, Key.Goal.NodeRef, SourcePoints.Last().Flags);
+
+	// corridor is used to invalidate the path on navmesh changes, make sure it covers the new endpoints
+	if (SourceNavMeshPath)
+	{
+		FNavMeshPath* NewNavMeshPath = NewPath->CastPath<FNavMeshPath>();
+		NewNavMeshPath->PathCorridor = SourceNavMeshPath->PathCorridor;
+		NewNavMeshPath->PathCorridorCost = SourceNavMeshPath->PathCorridorCost;
+		if (!NewNavMeshPath->PathCorridor.Contains(Key.StartPoly))
+		{
+			NewNavMeshPath->PathCorridor.Insert(Key.StartPoly, 0);
+			NewNavMeshPath->PathCorridorCost.Insert(0.f, 0);
+		}
+		if (!NewNavMeshPath->PathCorridor.Contains(Key.GoalPoly))
+		{
+			NewNavMeshPath->PathCorridor.Add(Key.GoalPoly);
+			NewNavMeshPath->PathCorridorCost.Add(0.f);
+		}
+	}
+
+	NewPath->MarkReady();
+
+	// navmesh changes only invalidate the copy, whoever moves along it decides to repath
+	NewPath->EnableRecalculationOnInvalidation(false);
+	return NewPath;
+}
+
+bool UShooterPathCache::IsEntryValid(const FShooterPathCacheEntry& Entry, float TimeSeconds) const
+{
+	return Entry.Path.IsValid() && Entry.Path->IsValid() && TimeSeconds - Entry.Time <= PathCacheLifetime;
+}
@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterPawnRegistry.h"
+#include "Online/ShooterPlayerState.h"
+#include "EngineUtils.h"
+
+static float PawnRegistryCellSize = 2000.0f;
+FAutoConsoleVariableRef CVarPawnRegistryCellSize(
+	TEXT("p.PawnRegistryCellSize"),
+	PawnRegistryCellSize,
+	TEXT("Grid cell size of the pawn registry used by bot enemy queries."),
+	ECVF_Default);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pawn Registry Queries"), STAT_ShooterPawnRegistryQueries, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pawn Registry Candidates"), STAT_ShooterPawnRegistryCandidates, STATGROUP_Game);
+
+void UShooterPawnRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LastUpdateFrame = MAX_uint64;
+	GridCellSize = PawnRegistryCellSize;
+}
+
+void UShooterPawnRegistry::UpdateRegistry()
+{
+	if (LastUpdateFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterPawnRegistry_Update);
+
+	LastUpdateFrame = GFrameCounter;
+	GridCellSize = FMath::Max(100.0f, PawnRegistryCellSize);
+
+	Entries.Reset();
+	Cells.Reset();
+	TeamEntries.Reset();
+	MinCell = FIntPoint(MAX_int32, MAX_int32);
+	MaxCell = FIntPoint(MIN_int32, MIN_int32);
+
+	for (AShooterCharacter* Pawn : TActorRange<AShooterCharacter>(GetWorld()))
+	{
+		if (!Pawn->IsAlive() || Pawn->IsPooled())
+		{
+			continue;
+		}
+
+		const AShooterPlayerState* PawnPlayerState = Cast<AShooterPlayerState>(Pawn->GetPlayerState());
+
+		const int32 EntryIndex = Entries.AddUninitialized();
+		FShooterPawnEntry& Entry = Entries[EntryIndex];
+		Entry.Pawn = Pawn;
+		Entry.Location = Pawn->GetActorLocation();
+		Entry.TeamNum = PawnPlayerState ? PawnPlayerState->GetTeamNum() : INDEX_NONE;
+
+		const FIntPoint Cell = GetCell(Entry.Location);
+		Cells.FindOrAdd(Cell).Add(EntryIndex);
+		TeamEntries.FindOrAdd(Entry.TeamNum).Add(EntryIndex);
+
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+	}
+}
+
+FIntPoint UShooterPawnRegistry::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / GridCellSize), FMath::FloorToInt(Location.Y / GridCellSize));
+}
+
+int32 UShooterPawnRegistry::FindNearestEnemies(AController* Querier, const FVector& Origin, float Radius, int32 MaxResults, TArray<AShooterCharacter*>& OutEnemies, const AShooterCharacter* ExcludePawn)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterPawnRegistry_FindNearestEnemies);
+	INC_DWORD_STAT(STAT_ShooterPawnRegistryQueries);
+
+	OutEnemies.Reset();
+	UpdateRegistry();
+
+	if (Entries.Num() == 0 || Querier == nullptr)
+	{
+		return 0;
+	}
+
+	const FIntPoint OriginCell = GetCell(Origin);
+	const float RadiusSq = Radius > 0.f ? FMath::Square(Radius) : MAX_flt;
+
+	// rings needed to cover the radius, or every occupied cell
+	const int32 MaxBoundsRing = FMath::Max(
+		FMath::Max(FMath::Abs(MinCell.X - OriginCell.X), FMath::Abs(MaxCell.X - OriginCell.X)),
+		FMath::Max(FMath::Abs(MinCell.Y - OriginCell.Y), FMath::Abs(MaxCell.Y - OriginCell.Y)));
+	const int32 MaxRing = Radius > 0.f ? FMath::Min(MaxBoundsRing, FMath::CeilToInt(Radius / GridCellSize)) : MaxBoundsRing;
+
+	TArray<TPair<float, AShooterCharacter*>, TInlineAllocator<16>> Candidates;
+	auto SortCandidates = [&Candidates]()
+	{
+		Candidates.Sort([](const TPair<float, AShooterCharacter*>& A, const TPair<float, AShooterCharacter*>& B) { return A.Key < B.Key; });
+	};
+
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		if (MaxResults > 0 && Candidates.Num() >= MaxResults && Ring > 1)
+		{
+			// every cell on this ring is at least Ring - 1 cells away
+			SortCandidates();
+			if (Candidates[MaxResults - 1].Key <= FMath::Square((Ring - 1) * GridCellSize))
+			{
+				break;
+			}
+		}
+
+		const int32 MinX = FMath::Max(OriginCell.X - Ring, MinCell.X);
+		const int32 MaxX = FMath::Min(OriginCell.X + Ring, MaxCell.X);
+		const int32 MinY = FMath::Max(OriginCell.Y - Ring, MinCell.Y);
+		const int32 MaxY = FMath::Min(OriginCell.Y + Ring, MaxCell.Y);
+
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			const bool bEdgeColumn = (FMath::Abs(X - OriginCell.X) == Ring);
+			for (int32 Y = MinY; Y <= MaxY; Y++)
+			{
+				// ring perimeter only, inner cells were visited before
+				if (!bEdgeColumn && FMath::Abs(Y - OriginCell.Y) != Ring)
+				{
+					continue;
+				}
+
+				const TArray<int32>* CellEntries = Cells.Find(FIntPoint(X, Y));
+				if (CellEntries == nullptr)
+				{
+					continue;
+				}
+
+				for (int32 EntryIndex : *CellEntries)
+				{
+					const FShooterPawnEntry& Entry = Entries[EntryIndex];
+					AShooterCharacter* Pawn = Entry.Pawn;
+					if (Pawn == ExcludePawn || !IsValid(Pawn) || !Pawn->IsAlive())
+					{
+						continue;
+					}
+
+					const float DistSq = FVector::DistSquared(Entry.Location, Origin);
+					if (DistSq <= RadiusSq && Pawn->IsEnemyFor(Querier))
+					{
+						Candidates.Emplace(DistSq, Pawn);
+					}
+				}
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_ShooterPawnRegistryCandidates, Candidates.Num());
+
+	SortCandidates();
+	const int32 NumResults = MaxResults > 0 ? FMath::Min(MaxResults, Candidates.Num()) : Candidates.Num();
+	for (int32 i = 0; i < NumResults; i++)
+	{
+		OutEnemies.Add(Candidates[i].Value);
+	}
+
+	return NumResults;
+}
+
+void UShooterPawnRegistry::GetTeamPawns(int32 TeamNum, TArray<AShooterCharacter*>& OutPawns)
+{
+	OutPawns.Reset();
+	UpdateRegistry();
+
+	if (const TArray<int32>* TeamIndices = TeamEntries.Find(TeamNum))
+	{
+		for (int32 EntryIndex : *TeamIndices)
+		{
+			AShooterCharacter* Pawn = Entries[EntryIndex].Pawn;
+			if (IsValid(Pawn) && Pawn->IsAlive())
+			{
+				OutPawns.Add(Pawn);
+			}
+		}
+	}
+}
+
+const TArray<FShooterPawnEntry>& UShooterPawnRegistry::GetPawns()
+{
+	UpdateRegistry();
+	return Entries;
+}
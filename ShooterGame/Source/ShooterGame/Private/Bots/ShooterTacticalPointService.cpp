@@ -0,0 +1,359 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterTacticalPointService.h"
+#include "Bots/ShooterPawnRegistry.h"
+#include "Online/ShooterPlayerState.h"
+#include "NavigationSystem.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+
+static float TacticalPointRange = 600.0f;
+FAutoConsoleVariableRef CVarTacticalPointRange(
+	TEXT("p.TacticalPointRange"),
+	TacticalPointRange,
+	TEXT("Preferred distance of bot positions from their enemy."),
+	ECVF_Default);
+
+static int32 TacticalPointsPerRing = 8;
+FAutoConsoleVariableRef CVarTacticalPointsPerRing(
+	TEXT("p.TacticalPointsPerRing"),
+	TacticalPointsPerRing,
+	TEXT("Candidates on each of the three rings around an enemy."),
+	ECVF_Default);
+
+static float TacticalPointRefreshInterval = 1.0f;
+FAutoConsoleVariableRef CVarTacticalPointRefreshInterval(
+	TEXT("p.TacticalPointRefreshInterval"),
+	TacticalPointRefreshInterval,
+	TEXT("Seconds before points around an enemy are generated again."),
+	ECVF_Default);
+
+static float TacticalPointMoveThreshold = 300.0f;
+FAutoConsoleVariableRef CVarTacticalPointMoveThreshold(
+	TEXT("p.TacticalPointMoveThreshold"),
+	TacticalPointMoveThreshold,
+	TEXT("Points are generated again once their enemy moved this far."),
+	ECVF_Default);
+
+static float TacticalPointForgetTime = 3.0f;
+FAutoConsoleVariableRef CVarTacticalPointForgetTime(
+	TEXT("p.TacticalPointForgetTime"),
+	TacticalPointForgetTime,
+	TEXT("Enemies no bot asked about for this long are forgotten."),
+	ECVF_Default);
+
+/** eye height above the navmesh of a standing bot */
+static const float TacticalEyeHeight = 150.0f;
+
+/** height above the navmesh of the cover trace */
+static const float TacticalCoverHeight = 60.0f;
+
+/** obstacles closer than this to the point count as cover */
+static const float TacticalCoverDistance = 250.0f;
+
+/** points closer than this to a claimed point or a teammate are crowded */
+static const float TacticalCrowdRadius = 300.0f;
+
+/** claims are kept this long */
+static const float TacticalClaimTime = 3.0f;
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tactical Queries"), STAT_ShooterTacticalQueries, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tactical Points Generated"), STAT_ShooterTacticalPointsGenerated, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tactical Point Picks"), STAT_ShooterTacticalPointPicks, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tactical Point Misses"), STAT_ShooterTacticalPointMisses, STATGROUP_Game);
+
+bool UShooterTacticalPointService::FindPointNearEnemy(AController* Querier, AShooterCharacter* Enemy, FVector& OutLocation)
+{
+	APawn* MyPawn = Querier ? Querier->GetPawn() : nullptr;
+	if (MyPawn == nullptr || Enemy == nullptr)
+	{
+		return false;
+	}
+
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	FShooterTacticalQuery& Query = Queries.FindOrAdd(Enemy);
+	Query.LastRequestTime = TimeSeconds;
+
+	if (Query.Points.Num() == 0)
+	{
+		INC_DWORD_STAT(STAT_ShooterTacticalPointMisses);
+		return false;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterTacticalPointService_FindPoint);
+
+	TArray<AShooterCharacter*> Teammates;
+	const AShooterPlayerState* MyPlayerState = Cast<AShooterPlayerState>(Querier->PlayerState);
+	UShooterPawnRegistry* PawnRegistry = GetWorld()->GetSubsystem<UShooterPawnRegistry>();
+	if (MyPlayerState && PawnRegistry)
+	{
+		PawnRegistry->GetTeamPawns(MyPlayerState->GetTeamNum(), Teammates);
+	}
+
+	const FVector MyLocation = MyPawn->GetActorLocation();
+	const float CrowdRadiusSq = FMath::Square(TacticalCrowdRadius);
+
+	const FShooterTacticalPoint* BestPoint = nullptr;
+	float BestScore = -MAX_flt;
+	for (const FShooterTacticalPoint& Point : Query.Points)
+	{
+		// prefer points on the way over points behind the enemy
+		float Score = Point.Score - FVector::Dist(MyLocation, Point.Location) / 1000.0f;
+
+		for (const FShooterTacticalClaim& Claim : Query.Claims)
+		{
+			if (Claim.Controller != Querier && FVector::DistSquared(Claim.Location, Point.Location) < CrowdRadiusSq)
+			{
+				Score -= 1.0f;
+			}
+		}
+
+		for (const AShooterCharacter* Teammate : Teammates)
+		{
+			if (Teammate != MyPawn && Teammate != Enemy && FVector::DistSquared(Teammate->GetActorLocation(), Point.Location) < CrowdRadiusSq)
+			{
+				Score -= 0.5f;
+			}
+		}
+
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestPoint = &Point;
+		}
+	}
+
+	Query.Claims.RemoveAllSwap([Querier](const FShooterTacticalClaim& Claim) { return Claim.Controller == Querier; });
+
+	FShooterTacticalClaim& Claim = Query.Claims.AddDefaulted_GetRef();
+	Claim.Controller = Querier;
+	Claim.Location = BestPoint->Location;
+	Claim.Time = TimeSeconds;
+
+	INC_DWORD_STAT(STAT_ShooterTacticalPointPicks);
+	OutLocation = BestPoint->Location;
+	return true;
+}
+
+void UShooterTacticalPointService::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterTacticalPointService_Tick);
+
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	if (ScoringFuture.IsValid() && ScoringFuture.IsReady())
+	{
+		TArray<FScoreJob> FinishedJobs = ScoringFuture.Get();
+		ScoringFuture.Reset();
+
+		for (FScoreJob& Job : FinishedJobs)
+		{
+			FShooterTacticalQuery* Query = Queries.Find(Job.Enemy);
+			if (Query && Query->Generation == Job.Generation)
+			{
+				Query->Points = MoveTemp(Job.Points);
+				Query->ScoredEnemyLocation = Job.EnemyLocation;
+				Query->ResultTime = TimeSeconds;
+				Query->bScoring = false;
+			}
+		}
+	}
+
+	const bool bCanStartScoring = !ScoringFuture.IsValid();
+	TArray<FScoreJob> Jobs;
+
+	for (auto It = Queries.CreateIterator(); It; ++It)
+	{
+		AShooterCharacter* Enemy = It.Key().Get();
+		FShooterTacticalQuery& Query = It.Value();
+
+		if (Enemy == nullptr || !Enemy->IsAlive() || TimeSeconds - Query.LastRequestTime > TacticalPointForgetTime)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		Query.Claims.RemoveAllSwap([TimeSeconds](const FShooterTacticalClaim& Claim)
+		{
+			return !Claim.Controller.IsValid() || TimeSeconds - Claim.Time > TacticalClaimTime;
+		});
+
+		if (Query.bScoring || Query.NumPendingTraces > 0)
+		{
+			continue;
+		}
+
+		if (Query.PendingPoints.Num() > 0)
+		{
+			if (bCanStartScoring)
+			{
+				FScoreJob& Job = Jobs.AddDefaulted_GetRef();
+				Job.Enemy = Enemy;
+				Job.Generation = Query.Generation;
+				Job.EnemyLocation = Query.PendingEnemyLocation;
+				Job.Points = MoveTemp(Query.PendingPoints);
+				Query.PendingPoints.Reset();
+				Query.bScoring = true;
+			}
+			continue;
+		}
+
+		const bool bExpired = TimeSeconds - Query.ResultTime > TacticalPointRefreshInterval;
+		const bool bEnemyMoved = FVector::DistSquared(Enemy->GetActorLocation(), Query.ScoredEnemyLocation) > FMath::Square(TacticalPointMoveThreshold);
+		if (Query.Generation == 0 || bExpired || bEnemyMoved)
+		{
+			GeneratePoints(Enemy, Query);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterTacticalQueries, Queries.Num());
+
+	if (Jobs.Num() > 0)
+	{
+		const float PreferredRange = FMath::Max(1.0f, TacticalPointRange);
+
+		// plain data only, nothing here touches the world
+		ScoringFuture = Async(EAsyncExecution::TaskGraph, [Jobs = MoveTemp(Jobs), PreferredRange]() mutable
+		{
+			ParallelFor(Jobs.Num(), [&Jobs, PreferredRange](int32 JobIndex)
+			{
+				FScoreJob& Job = Jobs[JobIndex];
+				for (FShooterTacticalPoint& Point : Job.Points)
+				{
+					const float Range = FVector::Dist2D(Point.Location, Job.EnemyLocation);
+					const float RangeFit = 1.0f - FMath::Min(1.0f, FMath::Abs(Range - PreferredRange) / PreferredRange);
+					const float Height = FMath::Clamp((Point.Location.Z - Job.EnemyLocation.Z) / 300.0f, -0.5f, 0.5f);
+
+					// no LOS: only useful when nothing else is left
+					Point.Score = Point.bHasLOS
+						? 1.0f + RangeFit + (Point.bHasCover ? 0.5f : 0.f) + Height * 0.5f
+						: 0.25f * RangeFit;
+				}
+			});
+
+			return MoveTemp(Jobs);
+		});
+	}
+}
+
+void UShooterTacticalPointService::GeneratePoints(AShooterCharacter* Enemy, FShooterTacticalQuery& Query)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterTacticalPointService_GeneratePoints);
+
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	if (NavSys == nullptr)
+	{
+		return;
+	}
+
+	if (!TraceDelegate.IsBound())
+	{
+		TraceDelegate.BindUObject(this, &UShooterTacticalPointService::OnTraceCompleted);
+	}
+
+	// unique across queries, a forgotten and restarted query never matches old traces
+	Query.Generation = ++LastGeneration;
+	Query.PendingPoints.Reset();
+	Query.PendingEnemyLocation = Enemy->GetActorLocation();
+	Query.ResultTime = World->GetTimeSeconds();
+
+	const FVector EnemyLocation = Query.PendingEnemyLocation;
+	const int32 NumPerRing = FMath::Max(1, TacticalPointsPerRing);
+	const float RingScales[] = { 0.66f, 1.0f, 1.33f };
+	const FVector ProjectExtent(200.0f, 200.0f, 300.0f);
+
+	for (int32 Ring = 0; Ring < UE_ARRAY_COUNT(RingScales); Ring++)
+	{
+		const float Radius = TacticalPointRange * RingScales[Ring];
+		for (int32 i = 0; i < NumPerRing; i++)
+		{
+			// rings are offset by half a step so they don't line up
+			const float Angle = (2.0f * PI * (i + 0.5f * (Ring % 2))) / NumPerRing;
+			const FVector Candidate = EnemyLocation + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Radius;
+
+			FNavLocation NavLocation;
+			if (!NavSys->ProjectPointToNavigation(Candidate, NavLocation, ProjectExtent))
+			{
+				continue;
+			}
+
+			const int32 PointIndex = Query.PendingPoints.AddDefaulted();
+			Query.PendingPoints[PointIndex].Location = NavLocation.Location;
+
+			FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(TacticalPointTrace), true);
+			for (int32 TraceIdx = 0; TraceIdx < 2; TraceIdx++)
+			{
+				const bool bCoverTrace = (TraceIdx == 1);
+				const FVector TraceStart = NavLocation.Location + FVector(0.f, 0.f, bCoverTrace ? TacticalCoverHeight : TacticalEyeHeight);
+
+				// 0 is never handed out
+				LastTraceId = FMath::Max(LastTraceId + 1, 1u);
+
+				FPendingTrace& PendingTrace = PendingTraces.Add(LastTraceId);
+				PendingTrace.Enemy = Enemy;
+				PendingTrace.Generation = Query.Generation;
+				PendingTrace.PointIndex = PointIndex;
+				PendingTrace.bCoverTrace = bCoverTrace;
+
+				World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, EnemyLocation, COLLISION_WEAPON, TraceParams,
+					FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, LastTraceId);
+				Query.NumPendingTraces++;
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_ShooterTacticalPointsGenerated, Query.PendingPoints.Num());
+}
+
+void UShooterTacticalPointService::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FPendingTrace PendingTrace;
+	if (!PendingTraces.RemoveAndCopyValue(Datum.UserData, PendingTrace))
+	{
+		return;
+	}
+
+	FShooterTacticalQuery* Query = Queries.Find(PendingTrace.Enemy);
+	if (Query == nullptr || Query->Generation != PendingTrace.Generation || !Query->PendingPoints.IsValidIndex(PendingTrace.PointIndex))
+	{
+		return;
+	}
+
+	Query->NumPendingTraces--;
+
+	const FHitResult* Hit = Datum.OutHits.Num() > 0 ? &Datum.OutHits[0] : nullptr;
+	const bool bBlocked = Hit && Hit->bBlockingHit && Hit->GetActor() != PendingTrace.Enemy.Get();
+
+	FShooterTacticalPoint& Point = Query->PendingPoints[PendingTrace.PointIndex];
+	if (PendingTrace.bCoverTrace)
+	{
+		Point.bHasCover = bBlocked && Cast<APawn>(Hit->GetActor()) == nullptr && Hit->Distance < TacticalCoverDistance;
+	}
+	else
+	{
+		Point.bHasLOS = !bBlocked;
+	}
+}
+
+bool UShooterTacticalPointService::IsTickable() const
+{
+	return Queries.Num() > 0 || ScoringFuture.IsValid();
+}
+
+ETickableTickType UShooterTacticalPointService::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterTacticalPointService::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterTacticalPointService::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterTacticalPointService, STATGROUP_Tickables);
+}
@@ -0,0 +1,172 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterTeamPerception.h"
+#include "Online/ShooterPlayerState.h"
+
+static int32 TeamPerception = 1;
+FAutoConsoleVariableRef CVarTeamPerception(
+	TEXT("p.TeamPerception"),
+	TeamPerception,
+	TEXT("Share enemies seen by bots with their team in team games.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float TeamPerceptionForgetTime = 2.0f;
+FAutoConsoleVariableRef CVarTeamPerceptionForgetTime(
+	TEXT("p.TeamPerceptionForgetTime"),
+	TeamPerceptionForgetTime,
+	TEXT("Seconds an enemy stays known to a team after it was last seen."),
+	ECVF_Default);
+
+static float TeamPerceptionTrustConfidence = 0.75f;
+FAutoConsoleVariableRef CVarTeamPerceptionTrustConfidence(
+	TEXT("p.TeamPerceptionTrustConfidence"),
+	TeamPerceptionTrustConfidence,
+	TEXT("Min confidence of a known enemy bots pick without their own trace."),
+	ECVF_Default);
+
+static float TeamPerceptionShareRadius = 1000.0f;
+FAutoConsoleVariableRef CVarTeamPerceptionShareRadius(
+	TEXT("p.TeamPerceptionShareRadius"),
+	TeamPerceptionShareRadius,
+	TEXT("Bots pick known enemies without their own trace only if they were seen from this close to them."),
+	ECVF_Default);
+
+static float TeamPerceptionScanInterval = 0.5f;
+FAutoConsoleVariableRef CVarTeamPerceptionScanInterval(
+	TEXT("p.TeamPerceptionScanInterval"),
+	TeamPerceptionScanInterval,
+	TEXT("Seconds between full enemy scans of a bot when its team knows no enemy it can pick."),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Team Known Enemies"), STAT_ShooterTeamKnownEnemies, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Team Sightings"), STAT_ShooterTeamSightings, STATGROUP_Game);
+
+void UShooterTeamPerception::ReportSighting(AController* Spotter, AActor* Target)
+{
+	AShooterCharacter* Enemy = Cast<AShooterCharacter>(Target);
+	APawn* SpotterPawn = Spotter ? Spotter->GetPawn() : nullptr;
+	UShooterTeamPerception* Perception = SpotterPawn ? Spotter->GetWorld()->GetSubsystem<UShooterTeamPerception>() : nullptr;
+	AShooterPlayerState* SpotterPlayerState = Spotter ? Cast<AShooterPlayerState>(Spotter->PlayerState) : nullptr;
+	if (Perception == nullptr || SpotterPlayerState == nullptr || Enemy == nullptr || !Perception->IsTeamGame()
+		|| !Enemy->IsAlive() || !Enemy->IsEnemyFor(Spotter))
+	{
+		return;
+	}
+
+	FShooterKnownEnemy& Known = Perception->TeamEnemies.FindOrAdd(SpotterPlayerState->GetTeamNum()).FindOrAdd(Enemy);
+	Known.Location = Enemy->GetActorLocation();
+	Known.SpotterLocation = SpotterPawn->GetActorLocation();
+	Known.LastSeenTime = Perception->GetWorld()->GetTimeSeconds();
+
+	INC_DWORD_STAT(STAT_ShooterTeamSightings);
+}
+
+bool UShooterTeamPerception::GetKnownEnemies(AController* Querier, TArray<FShooterPerceivedEnemy>& OutEnemies) const
+{
+	OutEnemies.Reset();
+
+	APawn* MyPawn = Querier ? Querier->GetPawn() : nullptr;
+	const AShooterPlayerState* MyPlayerState = Querier ? Cast<AShooterPlayerState>(Querier->PlayerState) : nullptr;
+	if (MyPawn == nullptr || MyPlayerState == nullptr || !IsTeamGame())
+	{
+		return false;
+	}
+
+	const TMap<TWeakObjectPtr<AShooterCharacter>, FShooterKnownEnemy>* KnownEnemies = TeamEnemies.Find(MyPlayerState->GetTeamNum());
+	if (KnownEnemies == nullptr)
+	{
+		return true;
+	}
+
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	const FVector MyLocation = MyPawn->GetActorLocation();
+	const float ShareRadiusSq = FMath::Square(TeamPerceptionShareRadius);
+	const float ForgetTime = FMath::Max(TeamPerceptionForgetTime, KINDA_SMALL_NUMBER);
+
+	for (const auto& KnownPair : *KnownEnemies)
+	{
+		AShooterCharacter* Enemy = KnownPair.Key.Get();
+		const FShooterKnownEnemy& Known = KnownPair.Value;
+		const float Age = TimeSeconds - Known.LastSeenTime;
+		if (Enemy == nullptr || !Enemy->IsAlive() || Age > ForgetTime)
+		{
+			continue;
+		}
+
+		FShooterPerceivedEnemy& Perceived = OutEnemies.AddDefaulted_GetRef();
+		Perceived.Enemy = Enemy;
+		Perceived.Age = Age;
+		Perceived.Confidence = 1.0f - Age / ForgetTime;
+		Perceived.bTrusted = Perceived.Confidence >= TeamPerceptionTrustConfidence && FVector::DistSquared(Known.SpotterLocation, MyLocation) <= ShareRadiusSq;
+	}
+
+	OutEnemies.Sort([&MyLocation](const FShooterPerceivedEnemy& A, const FShooterPerceivedEnemy& B)
+	{
+		return FVector::DistSquared(A.Enemy->GetActorLocation(), MyLocation) < FVector::DistSquared(B.Enemy->GetActorLocation(), MyLocation);
+	});
+
+	return true;
+}
+
+float UShooterTeamPerception::GetScanInterval() const
+{
+	return TeamPerceptionScanInterval;
+}
+
+bool UShooterTeamPerception::IsTeamGame() const
+{
+	const AShooterGameState* MyGameState = TeamPerception ? Cast<AShooterGameState>(GetWorld()->GetGameState()) : nullptr;
+	return MyGameState && MyGameState->NumTeams > 1;
+}
+
+void UShooterTeamPerception::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterTeamPerception_Tick);
+
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	int32 NumKnown = 0;
+	for (auto TeamIt = TeamEnemies.CreateIterator(); TeamIt; ++TeamIt)
+	{
+		for (auto It = TeamIt.Value().CreateIterator(); It; ++It)
+		{
+			const AShooterCharacter* Enemy = It.Key().Get();
+			if (Enemy == nullptr || !Enemy->IsAlive() || TimeSeconds - It.Value().LastSeenTime > TeamPerceptionForgetTime)
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		if (TeamIt.Value().Num() == 0)
+		{
+			TeamIt.RemoveCurrent();
+			continue;
+		}
+
+		NumKnown += TeamIt.Value().Num();
+	}
+
+	SET_DWORD_STAT(STAT_ShooterTeamKnownEnemies, NumKnown);
+}
+
+bool UShooterTeamPerception::IsTickable() const
+{
+	return TeamEnemies.Num() > 0;
+}
+
+ETickableTickType UShooterTeamPerception::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterTeamPerception::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterTeamPerception::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterTeamPerception, STATGROUP_Tickables);
+}
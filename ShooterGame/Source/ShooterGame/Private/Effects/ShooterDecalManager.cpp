@@ -0,0 +1,226 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Effects/ShooterDecalManager.h"
+#include "Components/DecalComponent.h"
+
+static int32 MaxWorldDecals = 64;
+FAutoConsoleVariableRef CVarMaxWorldDecals(
+	TEXT("p.MaxWorldDecals"),
+	MaxWorldDecals,
+	TEXT("Number of decal components kept by the decal manager, oldest decals are reused when the ring is full."),
+	ECVF_Default);
+
+static int32 MaxDecalsPerFrame = 4;
+FAutoConsoleVariableRef CVarMaxDecalsPerFrame(
+	TEXT("p.MaxDecalsPerFrame"),
+	MaxDecalsPerFrame,
+	TEXT("Max decals placed per frame, explosions and decals close to the view are placed first. 0: unlimited"),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Decal Components Allocated"), STAT_ShooterDecalsAllocated, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Decals Dropped"), STAT_ShooterDecalsDropped, STATGROUP_Game);
+
+void UShooterDecalManager::SpawnDecal(const UObject* WorldContextObject, const FDecalData& Decal, const FVector& DecalSize, const FHitResult& SurfaceHit, bool bExplosion)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (World == nullptr || World->GetNetMode() == NM_DedicatedServer || Decal.DecalMaterial == nullptr)
+	{
+		return;
+	}
+
+	UShooterDecalManager* DecalManager = World->GetSubsystem<UShooterDecalManager>();
+	if (DecalManager == nullptr)
+	{
+		return;
+	}
+
+	FShooterDecalRequest& Request = DecalManager->PendingRequests.AddDefaulted_GetRef();
+	Request.Decal = Decal;
+	Request.DecalSize = DecalSize;
+	Request.Location = SurfaceHit.ImpactPoint;
+	Request.Rotation = SurfaceHit.ImpactNormal.Rotation();
+	Request.Rotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
+	Request.AttachComponent = SurfaceHit.Component;
+	Request.AttachBoneName = SurfaceHit.BoneName;
+	Request.bExplosion = bExplosion;
+	Request.DistanceSq = DecalManager->GetViewDistanceSq(Request.Location);
+}
+
+void UShooterDecalManager::Deinitialize()
+{
+	for (const FShooterDecalSlot& Slot : Slots)
+	{
+		if (Slot.Decal)
+		{
+			Slot.Decal->DestroyComponent();
+			DEC_DWORD_STAT(STAT_ShooterDecalsAllocated);
+		}
+	}
+
+	Slots.Empty();
+	PendingRequests.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterDecalManager::Tick(float DeltaTime)
+{
+	ExpireDecals();
+	FlushRequests();
+}
+
+bool UShooterDecalManager::IsTickable() const
+{
+	return !IsTemplate() && (PendingRequests.Num() > 0 || Slots.Num() > 0);
+}
+
+ETickableTickType UShooterDecalManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterDecalManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterDecalManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterDecalManager, STATGROUP_Tickables);
+}
+
+void UShooterDecalManager::FlushRequests()
+{
+	if (PendingRequests.Num() == 0)
+	{
+		return;
+	}
+
+	// explosions first, then closest to the view
+	PendingRequests.Sort([](const FShooterDecalRequest& A, const FShooterDecalRequest& B)
+	{
+		if (A.bExplosion != B.bExplosion)
+		{
+			return A.bExplosion;
+		}
+		return A.DistanceSq < B.DistanceSq;
+	});
+
+	const int32 NumToPlace = MaxDecalsPerFrame > 0 ? FMath::Min(PendingRequests.Num(), MaxDecalsPerFrame) : PendingRequests.Num();
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	for (int32 i = 0; i < NumToPlace; i++)
+	{
+		const FShooterDecalRequest& Request = PendingRequests[i];
+
+		const int32 SlotIndex = FindSlot(Request.bExplosion);
+		if (SlotIndex == INDEX_NONE)
+		{
+			INC_DWORD_STAT(STAT_ShooterDecalsDropped);
+			continue;
+		}
+
+		FShooterDecalSlot& Slot = Slots[SlotIndex];
+		if (Slot.Decal == nullptr)
+		{
+			Slot.Decal = NewObject<UDecalComponent>(GetWorld());
+			Slot.Decal->bAllowAnyoneToDestroyMe = true;
+			Slot.Decal->SetUsingAbsoluteScale(true);
+			Slot.Decal->RegisterComponentWithWorld(GetWorld());
+			INC_DWORD_STAT(STAT_ShooterDecalsAllocated);
+		}
+
+		UDecalComponent* Decal = Slot.Decal;
+		Decal->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+		Decal->SetDecalMaterial(Request.Decal.DecalMaterial);
+		Decal->DecalSize = Request.DecalSize;
+		Decal->SetWorldLocationAndRotation(Request.Location, Request.Rotation);
+
+		USceneComponent* AttachComponent = Request.AttachComponent.Get();
+		if (AttachComponent && AttachComponent->Mobility == EComponentMobility::Movable)
+		{
+			// static surfaces never move, only stick to things that do
+			Decal->AttachToComponent(AttachComponent, FAttachmentTransformRules::KeepWorldTransform, Request.AttachBoneName);
+		}
+
+		Decal->SetVisibility(true);
+		Decal->MarkRenderStateDirty();
+
+		Slot.SpawnTime = TimeSeconds;
+		Slot.ExpireTime = Request.Decal.LifeSpan > 0.f ? TimeSeconds + Request.Decal.LifeSpan : MAX_flt;
+		Slot.bExplosion = Request.bExplosion;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ShooterDecalsDropped, PendingRequests.Num() - NumToPlace);
+	PendingRequests.Reset();
+}
+
+void UShooterDecalManager::ExpireDecals()
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	const int32 MaxSlots = FMath::Max(1, MaxWorldDecals);
+
+	for (int32 i = Slots.Num() - 1; i >= 0; i--)
+	{
+		FShooterDecalSlot& Slot = Slots[i];
+		if (i >= MaxSlots)
+		{
+			// budget was lowered
+			if (Slot.Decal)
+			{
+				Slot.Decal->DestroyComponent();
+				DEC_DWORD_STAT(STAT_ShooterDecalsAllocated);
+			}
+			Slots.RemoveAt(i, 1, false);
+		}
+		else if (Slot.Decal && Slot.ExpireTime <= TimeSeconds && Slot.Decal->IsVisible())
+		{
+			Slot.Decal->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+			Slot.Decal->SetVisibility(false);
+		}
+	}
+}
+
+int32 UShooterDecalManager::FindSlot(bool bExplosion)
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	int32 OldestIndex = INDEX_NONE;
+	for (int32 i = 0; i < Slots.Num(); i++)
+	{
+		const FShooterDecalSlot& Slot = Slots[i];
+		if (Slot.Decal == nullptr || Slot.ExpireTime <= TimeSeconds)
+		{
+			return i;
+		}
+
+		// bullet holes may not replace explosion decals
+		if ((bExplosion || !Slot.bExplosion) && (OldestIndex == INDEX_NONE || Slot.SpawnTime < Slots[OldestIndex].SpawnTime))
+		{
+			OldestIndex = i;
+		}
+	}
+
+	if (Slots.Num() < FMath::Max(1, MaxWorldDecals))
+	{
+		return Slots.AddDefaulted();
+	}
+
+	return OldestIndex;
+}
+
+float UShooterDecalManager::GetViewDistanceSq(const FVector& Location) const
+{
+	float BestDistanceSq = MAX_flt;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			BestDistanceSq = FMath::Min(BestDistanceSq, FVector::DistSquared(PC->PlayerCameraManager->GetCameraLocation(), Location));
+		}
+	}
+
+	return BestDistanceSq;
+}
@@ -2,6 +2,8 @@
 
 #include "ShooterGame.h"
 #include "ShooterExplosionEffect.h"
+#include "Effects/ShooterDecalManager.h"
+#include "Sound/ShooterAudioManager.h"
 
 AShooterExplosionEffect::AShooterExplosionEffect(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -32,19 +34,10 @@ void AShooterExplosionEffect::BeginPlay()
 
 	if (ExplosionSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation());
+		UShooterAudioManager::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation(), EShooterSoundCategory::Explosion);
 	}
 
-	if (Decal.DecalMaterial)
-	{
-		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
-		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
-
-		UGameplayStatics::SpawnDecalAttached(Decal.DecalMaterial, FVector(Decal.DecalSize, Decal.DecalSize, 1.0f),
-			SurfaceHit.Component.Get(), SurfaceHit.BoneName,
-			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
-			Decal.LifeSpan);
-	}
+	UShooterDecalManager::SpawnDecal(this, Decal, FVector(Decal.DecalSize, Decal.DecalSize, 1.0f), SurfaceHit, true);
 }
 
 void AShooterExplosionEffect::Tick(float DeltaSeconds)
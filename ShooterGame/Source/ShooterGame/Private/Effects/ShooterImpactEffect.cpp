@@ -2,6 +2,8 @@
 
 #include "ShooterGame.h"
 #include "ShooterImpactEffect.h"
+#include "Effects/ShooterDecalManager.h"
+#include "Sound/ShooterAudioManager.h"
 
 AShooterImpactEffect::AShooterImpactEffect(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -26,19 +28,10 @@ void AShooterImpactEffect::PostInitializeComponents()
 	USoundCue* ImpactSound = GetImpactSound(HitSurfaceType);
 	if (ImpactSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+		UShooterAudioManager::PlaySoundAtLocation(this, ImpactSound, GetActorLocation(), EShooterSoundCategory::Impact);
 	}
 
-	if (DefaultDecal.DecalMaterial)
-	{
-		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
-		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
-
-		UGameplayStatics::SpawnDecalAttached(DefaultDecal.DecalMaterial, FVector(1.0f, DefaultDecal.DecalSize, DefaultDecal.DecalSize),
-			SurfaceHit.Component.Get(), SurfaceHit.BoneName,
-			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
-			DefaultDecal.LifeSpan);
-	}
+	UShooterDecalManager::SpawnDecal(this, DefaultDecal, FVector(1.0f, DefaultDecal.DecalSize, DefaultDecal.DecalSize), SurfaceHit, false);
 }
 
 UParticleSystem* AShooterImpactEffect::GetImpactFX(TEnumAsByte<EPhysicalSurface> SurfaceType) const
@@ -8,4 +8,8 @@ AMyShooterPickup_DeathAmmo::AMyShooterPickup_DeathAmmo(const FObjectInitializer&
 	AmmoClips = 2;
 	bCanRespawn = false;
 	RespawnTime = 5.0f;
+
+	// pooled, state changes are sent with a dormancy flush
+	NetDormancy = DORM_DormantAll;
+	SetReplicatingMovement(true);
 }
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include "Online/ShooterPlayerState.h"
 #include "Online/ShooterGameSession.h"
 #include "Bots/ShooterAIController.h"
+#include "Bots/ShooterBotManager.h"
+#include "Pickups/ShooterPickup.h"
+#include "Pickups/ShooterPickup_Ammo.h"
+#include "Weapons/ShooterWeapon.h"
 #include "ShooterTeamStart.h"
 
 
@@ -31,6 +35,10 @@ AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer)
 
 	bAllowBots = true;	
 	bNeedsBotCreation = true;
+	MaxPooledPawns = 16;
+	MaxPooledPickups = 16;
+	NumPrewarmedPickups = 4;
+	bReuseBotControllers = true;
 	bUseSeamlessTravel = FParse::Param(FCommandLine::Get(), TEXT("NoSeamlessTravel")) ? false : true;
 }
 
@@ -167,6 +175,7 @@ void AShooterGameMode::HandleMatchHasStarted()
 	AShooterGameState* const MyGameState = Cast<AShooterGameState>(GameState);
 	MyGameState->RemainingTime = RoundTime;	
 	StartBots();	
+	PrewarmPickupPool();
 
 	// notify players
 	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
@@ -366,6 +375,162 @@ UClass* AShooterGameMode::GetDefaultPawnClassForController_Implementation(AContr
 	return Super::GetDefaultPawnClassForController_Implementation(InController);
 }
 
+APawn* AShooterGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+	AShooterCharacter* PooledPawn = TakePawnFromPool(GetDefaultPawnClassForController(NewPlayer));
+	if (PooledPawn)
+	{
+		PooledPawn->ReuseFromPool(SpawnTransform);
+		return PooledPawn;
+	}
+
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
+
+bool AShooterGameMode::CanPoolPawn(const AShooterCharacter* Pawn) const
+{
+	return Pawn && MaxPooledPawns > 0 && GetMatchState() != MatchState::LeavingMap;
+}
+
+bool AShooterGameMode::AddPawnToPool(AShooterCharacter* Pawn)
+{
+	// drop entries destroyed behind our back (level cleanup, kill volumes)
+	PawnPool.RemoveAll([](const AShooterCharacter* PooledPawn) { return PooledPawn == NULL || PooledPawn->IsPendingKill(); });
+
+	if (!CanPoolPawn(Pawn) || PawnPool.Num() >= MaxPooledPawns)
+	{
+		return false;
+	}
+
+	PawnPool.AddUnique(Pawn);
+	return true;
+}
+
+AShooterCharacter* AShooterGameMode::TakePawnFromPool(UClass* PawnClass)
+{
+	for (int32 i = PawnPool.Num() - 1; i >= 0; i--)
+	{
+		AShooterCharacter* PooledPawn = PawnPool[i];
+		if (PooledPawn == NULL || PooledPawn->IsPendingKill())
+		{
+			PawnPool.RemoveAtSwap(i);
+		}
+		else if (PooledPawn->GetClass() == PawnClass)
+		{
+			PawnPool.RemoveAtSwap(i);
+			return PooledPawn;
+		}
+	}
+
+	return NULL;
+}
+
+AShooterPickup* AShooterGameMode::SpawnDroppedPickup(TSubclassOf<AShooterPickup> PickupClass, const FTransform& SpawnTransform, AShooterWeapon* DroppedWeapon)
+{
+	if (PickupClass == NULL)
+	{
+		return NULL;
+	}
+
+	AShooterPickup* Pickup = NULL;
+	for (int32 i = PickupPool.Num() - 1; i >= 0; i--)
+	{
+		AShooterPickup* PooledPickup = PickupPool[i];
+		if (PooledPickup == NULL || PooledPickup->IsPendingKill())
+		{
+			PickupPool.RemoveAtSwap(i);
+		}
+		else if (PooledPickup->GetClass() == PickupClass)
+		{
+			PickupPool.RemoveAtSwap(i);
+			Pickup = PooledPickup;
+			break;
+		}
+	}
+
+	const bool bReused = Pickup != NULL;
+	if (!bReused)
+	{
+		Pickup = GetWorld()->SpawnActorDeferred<AShooterPickup>(PickupClass, SpawnTransform);
+		if (Pickup == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	// set up before the pickup activates, a pawn standing on the drop gets it right away
+	AShooterPickup_Ammo* AmmoPickup = Cast<AShooterPickup_Ammo>(Pickup);
+	if (AmmoPickup)
+	{
+		AmmoPickup->DroppedByPlayerDeath(DroppedWeapon);
+	}
+
+	if (bReused)
+	{
+		Pickup->ReuseFromPool(SpawnTransform);
+	}
+	else
+	{
+		UGameplayStatics::FinishSpawningActor(Pickup, SpawnTransform);
+	}
+
+	return Pickup;
+}
+
+bool AShooterGameMode::AddPickupToPool(AShooterPickup* Pickup)
+{
+	// drop entries destroyed behind our back (level cleanup)
+	PickupPool.RemoveAll([](const AShooterPickup* PooledPickup) { return PooledPickup == NULL || PooledPickup->IsPendingKill(); });
+
+	if (Pickup == NULL || PickupPool.Num() >= MaxPooledPickups || GetMatchState() == MatchState::LeavingMap)
+	{
+		return false;
+	}
+
+	PickupPool.AddUnique(Pickup);
+	return true;
+}
+
+void AShooterGameMode::PrewarmPickupPool()
+{
+	TArray<UClass*, TInlineAllocator<8>> DropClasses;
+	for (UClass* PawnClass : { *DefaultPawnClass, *BotPawnClass })
+	{
+		const AShooterCharacter* DefPawn = PawnClass ? Cast<AShooterCharacter>(PawnClass->GetDefaultObject()) : NULL;
+		if (DefPawn)
+		{
+			for (const TSubclassOf<AShooterWeapon>& WeaponClass : DefPawn->GetDefaultInventoryClasses())
+			{
+				const AShooterWeapon* DefWeapon = WeaponClass ? WeaponClass->GetDefaultObject<AShooterWeapon>() : NULL;
+				if (DefWeapon && DefWeapon->ammoDropType)
+				{
+					DropClasses.AddUnique(DefWeapon->ammoDropType);
+				}
+			}
+		}
+	}
+
+	for (UClass* DropClass : DropClasses)
+	{
+		int32 NumPooled = 0;
+		for (const AShooterPickup* PooledPickup : PickupPool)
+		{
+			NumPooled += (PooledPickup && PooledPickup->GetClass() == DropClass) ? 1 : 0;
+		}
+
+		for (int32 i = NumPooled; i < NumPrewarmedPickups && PickupPool.Num() < MaxPooledPickups; i++)
+		{
+			// parked before BeginPlay so it never shows up or gets picked up at the spawn location
+			AShooterPickup* Pickup = GetWorld()->SpawnActorDeferred<AShooterPickup>(DropClass, FTransform::Identity);
+			if (Pickup)
+			{
+				Pickup->ReturnToPool();
+				UGameplayStatics::FinishSpawningActor(Pickup, FTransform::Identity);
+			}
+		}
+	}
+}
+
 void AShooterGameMode::RestartPlayer(AController* NewPlayer)
 {
 	Super::RestartPlayer(NewPlayer);
@@ -466,6 +631,13 @@ bool AShooterGameMode::IsSpawnpointPreferred(APlayerStart* SpawnPoint, AControll
 		const FVector SpawnLocation = SpawnPoint->GetActorLocation();
 		for (ACharacter* OtherPawn : TActorRange<ACharacter>(GetWorld()))
 		{
+			// parked pawns are hidden and don't block anything
+			const AShooterCharacter* OtherShooterPawn = Cast<AShooterCharacter>(OtherPawn);
+			if (OtherShooterPawn && OtherShooterPawn->IsPooled())
+			{
+				continue;
+			}
+
 			if (OtherPawn != MyPawn)
 			{
 				const float CombinedHeight = (MyPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + OtherPawn->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()) * 2.0f;
@@ -502,10 +674,18 @@ void AShooterGameMode::CreateBotControllers()
 	}
 
 	// Create any necessary AIControllers.  Hold off on Pawn creation until pawns are actually necessary or need recreating.	
+	UShooterBotManager* BotManager = World->GetSubsystem<UShooterBotManager>();
 	int32 BotNum = ExistingBots;
 	for (int32 i = 0; i < MaxBots - ExistingBots; ++i)
 	{
-		CreateBot(BotNum + i);
+		if (BotManager)
+		{
+			BotManager->QueueBotCreation(BotNum + i);
+		}
+		else
+		{
+			CreateBot(BotNum + i);
+		}
 	}
 }
 
@@ -527,10 +707,20 @@ void AShooterGameMode::StartBots()
 {
 	// checking number of existing human player.
 	UWorld* World = GetWorld();
+	UShooterBotManager* BotManager = World->GetSubsystem<UShooterBotManager>();
+	if (BotManager)
+	{
+		BotManager->BeginMatchStart();
+	}
+
 	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
 	{		
 		AShooterAIController* AIC = Cast<AShooterAIController>(*It);
-		if (AIC)
+		if (AIC && BotManager)
+		{
+			BotManager->QueueBotStart(AIC);
+		}
+		else if (AIC)
 		{
 			RestartPlayer(AIC);
 		}
@@ -569,3 +759,27 @@ void AShooterGameMode::RestartGame()
 	Super::RestartGame();
 }
 
+void AShooterGameMode::GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList)
+{
+	Super::GetSeamlessTravelActorList(bToTransition, ActorList);
+
+	if (!bReuseBotControllers)
+	{
+		return;
+	}
+
+	// the next game mode only creates the bots that are missing, pawns stay behind with the old level
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		AShooterAIController* AIC = Cast<AShooterAIController>(*It);
+		if (AIC && AIC->PlayerState)
+		{
+			if (bToTransition)
+			{
+				AIC->Reset();
+			}
+			ActorList.Add(AIC);
+		}
+	}
+}
+
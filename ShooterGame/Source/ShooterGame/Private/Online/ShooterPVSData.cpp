@@ -0,0 +1,245 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterPVSData.h"
+#include "Engine/LevelBounds.h"
+
+/** upper limit for baked cells, bit count grows with the square of it */
+static const int32 MaxPVSCells = 8192;
+
+UShooterPVSData::UShooterPVSData(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	Origin = FVector::ZeroVector;
+	CellSize = 500.0f;
+	Dimensions = FIntVector::ZeroValue;
+}
+
+int32 UShooterPVSData::GetCellIndex(const FVector& Location) const
+{
+	if (CellSize <= 0.f)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector Local = (Location - Origin) / CellSize;
+	const int32 X = FMath::FloorToInt(Local.X);
+	const int32 Y = FMath::FloorToInt(Local.Y);
+	const int32 Z = FMath::FloorToInt(Local.Z);
+	if (X < 0 || Y < 0 || Z < 0 || X >= Dimensions.X || Y >= Dimensions.Y || Z >= Dimensions.Z)
+	{
+		return INDEX_NONE;
+	}
+
+	return (Z * Dimensions.Y + Y) * Dimensions.X + X;
+}
+
+int32 UShooterPVSData::GetPairBitIndex(int32 CellA, int32 CellB)
+{
+	if (CellA > CellB)
+	{
+		Swap(CellA, CellB);
+	}
+
+	return CellB * (CellB + 1) / 2 + CellA;
+}
+
+bool UShooterPVSData::IsCellPairVisible(int32 CellA, int32 CellB) const
+{
+	if (CellA == INDEX_NONE || CellB == INDEX_NONE || CellA == CellB)
+	{
+		return true;
+	}
+
+	const int32 BitIndex = GetPairBitIndex(CellA, CellB);
+	if (!VisibilityBits.IsValidIndex(BitIndex >> 5))
+	{
+		return true;
+	}
+
+	return (VisibilityBits[BitIndex >> 5] & (1u << (BitIndex & 31))) != 0;
+}
+
+bool UShooterPVSData::IsPotentiallyVisible(const FVector& LocationA, const FVector& LocationB) const
+{
+	return IsCellPairVisible(GetCellIndex(LocationA), GetCellIndex(LocationB));
+}
+
+FString UShooterPVSData::GetPackageNameForWorld(const UWorld* World)
+{
+	const FString MapName = UWorld::RemovePIEPrefix(World->GetMapName());
+	return FString::Printf(TEXT("/Game/Maps/PVS/%s_PVS"), *MapName);
+}
+
+#if WITH_EDITOR
+bool UShooterPVSData::Bake(UWorld* World, float InCellSize)
+{
+	FBox Bounds(ForceInit);
+	for (ULevel* Level : World->GetLevels())
+	{
+		if (Level && Level->bIsVisible)
+		{
+			Bounds += ALevelBounds::CalculateLevelBounds(Level);
+		}
+	}
+
+	if (!Bounds.IsValid || InCellSize <= 0.f)
+	{
+		UE_LOG(LogShooter, Error, TEXT("PVS bake: no level bounds or bad cell size"));
+		return false;
+	}
+
+	const FVector Size = Bounds.GetSize();
+	const FIntVector NewDimensions(
+		FMath::Max(1, FMath::CeilToInt(Size.X / InCellSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Y / InCellSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Z / InCellSize)));
+
+	const int32 NumCells = NewDimensions.X * NewDimensions.Y * NewDimensions.Z;
+	if (NumCells > MaxPVSCells)
+	{
+		UE_LOG(LogShooter, Error, TEXT("PVS bake: %d cells of size %.0f, limit is %d. Use a larger cell size."), NumCells, InCellSize, MaxPVSCells);
+		return false;
+	}
+
+	Origin = Bounds.Min;
+	CellSize = InCellSize;
+	Dimensions = NewDimensions;
+
+	// cell centre and corners pulled inwards, anything a pawn in the cell could look from or be seen at
+	const int32 SamplesPerCell = 9;
+	TArray<FVector> Samples;
+	Samples.Reserve(NumCells * SamplesPerCell);
+	for (int32 Z = 0; Z < Dimensions.Z; Z++)
+	{
+		for (int32 Y = 0; Y < Dimensions.Y; Y++)
+		{
+			for (int32 X = 0; X < Dimensions.X; X++)
+			{
+				const FVector CellMin = Origin + FVector(X, Y, Z) * CellSize;
+				Samples.Add(CellMin + FVector(0.5f) * CellSize);
+				for (int32 Corner = 0; Corner < 8; Corner++)
+				{
+					const FVector Alpha((Corner & 1) ? 0.85f : 0.15f, (Corner & 2) ? 0.85f : 0.15f, (Corner & 4) ? 0.85f : 0.15f);
+					Samples.Add(CellMin + Alpha * CellSize);
+				}
+			}
+		}
+	}
+
+	const int32 NumBits = GetPairBitIndex(NumCells - 1, NumCells - 1) + 1;
+	TArray<uint32> TracedBits;
+	TracedBits.Init(0, (NumBits + 31) / 32);
+
+	FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(BakePVS), true);
+
+	for (int32 CellA = 0; CellA < NumCells; CellA++)
+	{
+		for (int32 CellB = CellA; CellB < NumCells; CellB++)
+		{
+			bool bVisible = (CellA == CellB);
+			for (int32 SampleA = 0; SampleA < SamplesPerCell && !bVisible; SampleA++)
+			{
+				for (int32 SampleB = 0; SampleB < SamplesPerCell && !bVisible; SampleB++)
+				{
+					bVisible = !World->LineTraceTestByChannel(Samples[CellA * SamplesPerCell + SampleA], Samples[CellB * SamplesPerCell + SampleB], ECC_Visibility, CollisionParams);
+				}
+			}
+
+			if (bVisible)
+			{
+				const int32 BitIndex = GetPairBitIndex(CellA, CellB);
+				TracedBits[BitIndex >> 5] |= 1u << (BitIndex & 31);
+			}
+		}
+
+		if ((CellA + 1) % FMath::Max(1, NumCells / 10) == 0)
+		{
+			UE_LOG(LogShooter, Display, TEXT("PVS bake: %d / %d cells"), CellA + 1, NumCells);
+		}
+	}
+
+	// samples can miss thin gaps, treat a cell as visible if any neighbour of it was
+	auto IsTracedVisible = [&](int32 CellA, int32 CellB)
+	{
+		const int32 BitIndex = GetPairBitIndex(CellA, CellB);
+		return (TracedBits[BitIndex >> 5] & (1u << (BitIndex & 31))) != 0;
+	};
+
+	auto IsNeighbourVisible = [&](int32 Cell, int32 OtherCell)
+	{
+		const int32 X = Cell % Dimensions.X;
+		const int32 Y = (Cell / Dimensions.X) % Dimensions.Y;
+		const int32 Z = Cell / (Dimensions.X * Dimensions.Y);
+		for (int32 DZ = -1; DZ <= 1; DZ++)
+		{
+			for (int32 DY = -1; DY <= 1; DY++)
+			{
+				for (int32 DX = -1; DX <= 1; DX++)
+				{
+					const int32 NX = X + DX, NY = Y + DY, NZ = Z + DZ;
+					if (NX >= 0 && NY >= 0 && NZ >= 0 && NX < Dimensions.X && NY < Dimensions.Y && NZ < Dimensions.Z
+						&& IsTracedVisible((NZ * Dimensions.Y + NY) * Dimensions.X + NX, OtherCell))
+					{
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	};
+
+	VisibilityBits.Init(0, TracedBits.Num());
+	int32 NumVisiblePairs = 0;
+	for (int32 CellA = 0; CellA < NumCells; CellA++)
+	{
+		for (int32 CellB = CellA; CellB < NumCells; CellB++)
+		{
+			if (IsNeighbourVisible(CellA, CellB) || IsNeighbourVisible(CellB, CellA))
+			{
+				const int32 BitIndex = GetPairBitIndex(CellA, CellB);
+				VisibilityBits[BitIndex >> 5] |= 1u << (BitIndex & 31);
+				NumVisiblePairs++;
+			}
+		}
+	}
+
+	UE_LOG(LogShooter, Display, TEXT("PVS bake: %d cells (%dx%dx%d), %d of %d pairs potentially visible, %d KB"),
+		NumCells, Dimensions.X, Dimensions.Y, Dimensions.Z, NumVisiblePairs, NumBits, VisibilityBits.Num() * 4 / 1024);
+
+	MarkPackageDirty();
+	return true;
+}
+
+FAutoConsoleCommandWithWorldAndArgs ShooterBakePVSCmd(TEXT("p.BakePVS"), TEXT("Bakes the potentially visible set of the current map. Optional argument: cell size (default 500)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr)
+		{
+			return;
+		}
+
+		float BakeCellSize = 500.0f;
+		if (Args.Num() > 0)
+		{
+			LexTryParseString<float>(BakeCellSize, *Args[0]);
+		}
+
+		const FString PackageName = UShooterPVSData::GetPackageNameForWorld(World);
+		const FString AssetName = FPackageName::GetShortName(PackageName);
+
+		UPackage* Package = CreatePackage(*PackageName);
+		UShooterPVSData* PVSData = FindObject<UShooterPVSData>(Package, *AssetName);
+		if (PVSData == nullptr)
+		{
+			PVSData = NewObject<UShooterPVSData>(Package, *AssetName, RF_Public | RF_Standalone);
+		}
+
+		if (PVSData->Bake(World, BakeCellSize))
+		{
+			const FString FileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+			UPackage::SavePackage(Package, PVSData, RF_Public | RF_Standalone, *FileName);
+			UE_LOG(LogShooter, Display, TEXT("PVS bake: saved %s"), *FileName);
+		}
+	})
+);
+#endif
@@ -38,7 +38,12 @@
 *		UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
 *		A custom node for handling player state replication. This replicates a small rolling set of player states (currently 2/frame). This is so player states replicate
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
-*		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection.
+*		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection. Player states that called ForceNetUpdate (kills, deaths, score) skip the rolling
+*		set and go out on the next frame.
+*		
+*		UShooterReplicationGraphNode_VisibilityCulled_ForConnection
+*		Connection specific node for pawns on maps with a baked potentially visible set (UShooterPVSData). Pawns are kept out of the grid and only returned to
+*		connections whose viewers are in a cell that can see the pawn's cell. Without a baked PVS pawns go to the grid like any other dynamic actor.
 *		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
@@ -95,8 +100,11 @@
 #include "Engine/LevelScriptActor.h"
 #include "Player/ShooterCharacter.h"
 #include "Online/ShooterPlayerState.h"
+#include "Online/ShooterPVSData.h"
+#include "Online/ShooterVisibilityManager.h"
 #include "Weapons/ShooterWeapon.h"
 #include "Pickups/ShooterPickup.h"
+#include "Pickups/ShooterPickup_Ammo.h"
 
 DEFINE_LOG_CATEGORY( LogShooterReplicationGraph );
 
@@ -156,6 +164,7 @@ void UShooterReplicationGraph::ResetGameWorldState()
 	Super::ResetGameWorldState();
 
 	AlwaysRelevantStreamingLevelActors.Empty();
+	VisibilityCulledActors.Reset();
 
 	for (UNetReplicationGraphConnection* ConnManager : Connections)
 	{
@@ -196,6 +205,8 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	AddInfo( AReplicationGraphDebugActor::StaticClass(),			EClassRepNodeMapping::NotRouted);				// Not needed. Replicated special case inside RepGraph
 	AddInfo( AInfo::StaticClass(),									EClassRepNodeMapping::RelevantAllConnections);	// Non spatialized, relevant to all
 	AddInfo( AShooterPickup::StaticClass(),							EClassRepNodeMapping::Spatialize_Static);		// Spatialized and never moves. Routes to GridNode.
+	AddInfo( AShooterPickup_Ammo::StaticClass(),					EClassRepNodeMapping::Spatialize_Dormancy);		// Dropped ammo is pooled and moved on reuse, waking it up re-spatializes it. Routes to GridNode.
+	AddInfo( AShooterCharacter::StaticClass(),						EClassRepNodeMapping::Spatialize_Visibility);	// Culled by the baked PVS if the map has one. Routes to GridNode otherwise.
 
 #if WITH_GAMEPLAY_DEBUGGER
 	AddInfo( AGameplayDebuggerCategoryReplicator::StaticClass(),	EClassRepNodeMapping::NotRouted);				// Replicated via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
@@ -397,6 +408,15 @@ void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConn
 	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
 
 	AddConnectionGraphNode(AlwaysRelevantConnectionNode, RepGraphConnection);
+
+	UShooterReplicationGraphNode_VisibilityCulled_ForConnection* VisibilityCulledConnectionNode = CreateNewNode<UShooterReplicationGraphNode_VisibilityCulled_ForConnection>();
+	AddConnectionGraphNode(VisibilityCulledConnectionNode, RepGraphConnection);
+}
+
+const UShooterPVSData* UShooterReplicationGraph::GetPVS() const
+{
+	UShooterVisibilityManager* VisibilityManager = GetWorld() ? GetWorld()->GetSubsystem<UShooterVisibilityManager>() : nullptr;
+	return VisibilityManager ? VisibilityManager->GetPVS() : nullptr;
 }
 
 EClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
@@ -447,6 +467,19 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
 			break;
 		}
+
+		case EClassRepNodeMapping::Spatialize_Visibility:
+		{
+			if (GetPVS())
+			{
+				VisibilityCulledActors.ConditionalAdd(ActorInfo.Actor);
+			}
+			else
+			{
+				GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+			}
+			break;
+		}
 	};
 }
 
@@ -494,6 +527,15 @@ void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicat
 			GridNode->RemoveActor_Dormancy(ActorInfo);
 			break;
 		}
+
+		case EClassRepNodeMapping::Spatialize_Visibility:
+		{
+			if (VisibilityCulledActors.RemoveFast(ActorInfo.Actor) == false)
+			{
+				GridNode->RemoveActor_Dynamic(ActorInfo);
+			}
+			break;
+		}
 	};
 }
 
@@ -750,6 +792,57 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplica
 
 // ------------------------------------------------------------------------------
 
+void UShooterReplicationGraphNode_VisibilityCulled_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_VisibilityCulled_ForConnection_GatherActorListsForConnection );
+
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+
+	ReplicationActorList.Reset();
+
+	if (ShooterGraph->VisibilityCulledActors.Num() == 0)
+	{
+		return;
+	}
+
+	// p.NetUsePVS was turned off after the pawns were routed here, don't cull them at all
+	const UShooterPVSData* PVS = ShooterGraph->GetPVS();
+	if (PVS == nullptr)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(ShooterGraph->VisibilityCulledActors);
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<4> > ViewerCells;
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		ViewerCells.AddUnique(PVS->GetCellIndex(CurViewer.ViewLocation));
+	}
+
+	for (FActorRepListType Actor : ShooterGraph->VisibilityCulledActors)
+	{
+		const int32 ActorCell = PVS->GetCellIndex(Actor->GetActorLocation());
+		for (int32 ViewerCell : ViewerCells)
+		{
+			if (PVS->IsCellPairVisible(ViewerCell, ActorCell))
+			{
+				ReplicationActorList.Add(Actor);
+				break;
+			}
+		}
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+}
+
+void UShooterReplicationGraphNode_VisibilityCulled_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+	DebugInfo.PopIndent();
+}
+
 UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::UShooterReplicationGraphNode_PlayerStateFrequencyLimiter()
 {
 	bRequiresPrepareForReplicationCall = true;
@@ -776,6 +869,13 @@ void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplica
 			continue;
 		}
 
+		// score changes call ForceNetUpdate, send them this frame instead of waiting for the bucket to come around
+		FGlobalActorReplicationInfo* GlobalInfo = GraphGlobals.IsValid() ? GraphGlobals->GlobalActorReplicationInfoMap->Find(PS) : nullptr;
+		if (GlobalInfo && GlobalInfo->ForceNetUpdateFrame >= LastPreparedFrame)
+		{
+			ForceNetUpdateReplicationActorList.Add(PS);
+		}
+
 		if (CurrentList->Num() >= TargetActorsPerFrame)
 		{
 			ReplicationActorLists.AddDefaulted();
@@ -783,7 +883,9 @@ void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplica
 		}
 		
 		CurrentList->Add(PS);
-	}	
+	}
+
+	LastPreparedFrame = GraphGlobals.IsValid() ? GraphGlobals->ReplicationGraph->GetReplicationGraphFrame() : 0;
 }
 
 void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
@@ -807,6 +909,7 @@ void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicat
 	{
 		LogActorRepList(DebugInfo, FString::Printf(TEXT("Bucket[%d]"), i++), List);
 	}
+	LogActorRepList(DebugInfo, TEXT("ForceNetUpdate"), ForceNetUpdateReplicationActorList);
 
 	DebugInfo.PopIndent();
 }
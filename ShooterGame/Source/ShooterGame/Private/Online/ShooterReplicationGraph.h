@@ -10,6 +10,7 @@ class AShooterCharacter;
 class AShooterWeapon;
 class UReplicationGraphNode_GridSpatialization2D;
 class AGameplayDebuggerCategoryReplicator;
+class UShooterPVSData;
 
 DECLARE_LOG_CATEGORY_EXTERN( LogShooterReplicationGraph, Display, All );
 
@@ -25,6 +26,7 @@ enum class EClassRepNodeMapping : uint32
 	Spatialize_Static,				// Routes to GridNode: these actors don't move and don't need to be updated every frame.
 	Spatialize_Dynamic,				// Routes to GridNode: these actors mode frequently and are updated once per frame.
 	Spatialize_Dormancy,			// Routes to GridNode: While dormant we treat as static. When flushed/not dormant dynamic. Note this is for things that "move while not dormant".
+	Spatialize_Visibility,			// Routes to VisibilityCulledActors when the map has a baked PVS, GridNode (dynamic) otherwise. Culled per connection by UShooterReplicationGraphNode_VisibilityCulled_ForConnection.
 };
 
 /** ShooterGame Replication Graph implementation. See additional notes in ShooterReplicationGraph.cpp! */
@@ -62,6 +64,12 @@ public:
 
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
+	/** Spatialize_Visibility actors, only used when the map has a baked PVS */
+	FActorRepListRefView VisibilityCulledActors;
+
+	/** Baked visibility for the current map, NULL if there is none */
+	const UShooterPVSData* GetPVS() const;
+
 	void OnCharacterEquipWeapon(AShooterCharacter* Character, AShooterWeapon* NewWeapon);
 	void OnCharacterUnEquipWeapon(AShooterCharacter* Character, AShooterWeapon* OldWeapon);
 
@@ -120,6 +128,27 @@ private:
 	bool bInitializedPlayerState = false;
 };
 
+/** Connection specific node returning the VisibilityCulledActors the baked PVS doesn't prove hidden from any of the connection's viewers. */
+UCLASS()
+class UShooterReplicationGraphNode_VisibilityCulled_ForConnection : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override { }
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+private:
+
+	FActorRepListRefView ReplicationActorList;
+};
+
 /** This is a specialized node for handling PlayerState replication in a frequency limited fashion. It tracks all player states but only returns a subset of them to the replication driver each frame. */
 UCLASS()
 class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicationGraphNode
@@ -144,4 +173,7 @@ private:
 	
 	TArray<FActorRepListRefView> ReplicationActorLists;
 	FActorRepListRefView ForceNetUpdateReplicationActorList;
+
+	/** graph frame of the last PrepareForReplication, player states force net updated since then skip the buckets */
+	uint32 LastPreparedFrame = 0;
 };
\ No newline at end of file
@@ -0,0 +1,254 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterVisibilityManager.h"
+#include "Online/ShooterPVSData.h"
+
+static int32 NetUsePVS = 1;
+FAutoConsoleVariableRef CVarNetUsePVS(
+	TEXT("p.NetUsePVS"),
+	NetUsePVS,
+	TEXT("Use the baked potentially visible set of the map to cull pawns before tracing or replicating them.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float VisibilityMaxAge = 0.25f;
+FAutoConsoleVariableRef CVarVisibilityMaxAge(
+	TEXT("p.NetVisibilityMaxAge"),
+	VisibilityMaxAge,
+	TEXT("Seconds a cached pawn visibility result is reused when neither end moved."),
+	ECVF_Default);
+
+static float VisibilityMoveThreshold = 50.0f;
+FAutoConsoleVariableRef CVarVisibilityMoveThreshold(
+	TEXT("p.NetVisibilityMoveThreshold"),
+	VisibilityMoveThreshold,
+	TEXT("Distance either end of a cached pawn visibility pair can move before it is traced again."),
+	ECVF_Default);
+
+static int32 VisibilityMaxUpdatesPerFrame = 128;
+FAutoConsoleVariableRef CVarVisibilityMaxUpdatesPerFrame(
+	TEXT("p.NetVisibilityMaxUpdatesPerFrame"),
+	VisibilityMaxUpdatesPerFrame,
+	TEXT("Max pawn visibility pairs traced per frame, the rest keep their last result. 0: unlimited"),
+	ECVF_Default);
+
+static int32 VisibilitySymmetric = 1;
+FAutoConsoleVariableRef CVarVisibilitySymmetric(
+	TEXT("p.NetVisibilitySymmetric"),
+	VisibilitySymmetric,
+	TEXT("Two pawns viewing each other share one visibility result.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+/** pairs not queried for this long are dropped */
+static const float VisibilityPairTimeout = 2.0f;
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Visibility Traces"), STAT_ShooterVisibilityTraces, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Visibility Pairs"), STAT_ShooterVisibilityPairs, STATGROUP_Game);
+
+bool UShooterVisibilityManager::IsVisible(AShooterCharacter* Pawn, APlayerController* Viewer)
+{
+	if (const UShooterPVSData* PVS = GetPVS())
+	{
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Viewer->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		if (!PVS->IsPotentiallyVisible(Pawn->GetActorLocation(), ViewLocation))
+		{
+			// proven hidden, don't register for traces
+			return false;
+		}
+	}
+
+	FShooterVisibilityPair& Pair = Pairs.FindOrAdd(GetPairKey(Pawn, Viewer));
+	if (!Pair.Pawn.IsValid() || !Pair.Viewer.IsValid())
+	{
+		Pair.Pawn = Pawn;
+		Pair.Viewer = Viewer;
+		Pair.bHasResult = false;
+	}
+
+	Pair.QueryTime = GetWorld()->GetTimeSeconds();
+
+	// unknown pairs replicate until the first result arrives
+	return !Pair.bHasResult || Pair.bVisible;
+}
+
+const UShooterPVSData* UShooterVisibilityManager::GetPVS()
+{
+	if (!NetUsePVS)
+	{
+		return nullptr;
+	}
+
+	if (!bPVSLoaded)
+	{
+		bPVSLoaded = true;
+
+		const FString PackageName = UShooterPVSData::GetPackageNameForWorld(GetWorld());
+		if (FPackageName::DoesPackageExist(PackageName))
+		{
+			const FString ObjectPath = PackageName + TEXT(".") + FPackageName::GetShortName(PackageName);
+			PVSData = LoadObject<UShooterPVSData>(nullptr, *ObjectPath);
+		}
+
+		UE_LOG(LogShooter, Log, TEXT("Potentially visible set %s: %s"), *PackageName, PVSData ? TEXT("loaded") : TEXT("not baked"));
+	}
+
+	return PVSData;
+}
+
+void UShooterVisibilityManager::Deinitialize()
+{
+	PVSData = nullptr;
+	Pairs.Empty();
+	SET_DWORD_STAT(STAT_ShooterVisibilityPairs, 0);
+
+	Super::Deinitialize();
+}
+
+void UShooterVisibilityManager::Tick(float DeltaTime)
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	int32 UpdatesLeft = VisibilityMaxUpdatesPerFrame > 0 ? VisibilityMaxUpdatesPerFrame : MAX_int32;
+
+	for (auto It = Pairs.CreateIterator(); It; ++It)
+	{
+		FShooterVisibilityPair& Pair = It.Value();
+
+		AShooterCharacter* Pawn = Pair.Pawn.Get();
+		APlayerController* Viewer = Pair.Viewer.Get();
+		if (Pawn == nullptr || Viewer == nullptr || TimeSeconds - Pair.QueryTime > VisibilityPairTimeout)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (Pair.PendingTraces.Num() > 0)
+		{
+			CollectTraces(Pair);
+			continue;
+		}
+
+		if (UpdatesLeft <= 0)
+		{
+			// pairs skipped here are older next frame, so everything gets its turn
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Viewer->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		if (NeedsUpdate(Pair, Pawn->GetActorLocation(), ViewLocation))
+		{
+			Pair.ViewLocation = ViewLocation;
+			StartTraces(Pair, Pawn, Viewer);
+			UpdatesLeft--;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterVisibilityPairs, Pairs.Num());
+}
+
+bool UShooterVisibilityManager::IsTickable() const
+{
+	return Pairs.Num() > 0;
+}
+
+ETickableTickType UShooterVisibilityManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterVisibilityManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterVisibilityManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterVisibilityManager, STATGROUP_Tickables);
+}
+
+uint64 UShooterVisibilityManager::GetPairKey(const AShooterCharacter* Pawn, const APlayerController* Viewer)
+{
+	const AShooterCharacter* ViewerPawn = VisibilitySymmetric ? Cast<AShooterCharacter>(Viewer->GetPawn()) : nullptr;
+
+	uint32 KeyA = Pawn->GetUniqueID();
+	uint32 KeyB = ViewerPawn ? ViewerPawn->GetUniqueID() : Viewer->GetUniqueID();
+	if (ViewerPawn && KeyB < KeyA)
+	{
+		Swap(KeyA, KeyB);
+	}
+
+	return (uint64(KeyA) << 32) | KeyB;
+}
+
+bool UShooterVisibilityManager::CollectTraces(FShooterVisibilityPair& Pair)
+{
+	UWorld* World = GetWorld();
+
+	bool bAnyClear = false;
+	for (const FTraceHandle& Handle : Pair.PendingTraces)
+	{
+		FTraceDatum TraceData;
+		if (World->QueryTraceData(Handle, TraceData))
+		{
+			bAnyClear |= (TraceData.OutHits.Num() == 0);
+		}
+		else if (World->IsTraceHandleValid(Handle, false))
+		{
+			// still running
+			return false;
+		}
+		else
+		{
+			// results expired before we got to them, keep the old result and trace again
+			Pair.PendingTraces.Reset();
+			return false;
+		}
+	}
+
+	Pair.PendingTraces.Reset();
+	Pair.bVisible = bAnyClear;
+	Pair.bHasResult = true;
+	Pair.UpdateTime = World->GetTimeSeconds();
+
+	return true;
+}
+
+int32 UShooterVisibilityManager::StartTraces(FShooterVisibilityPair& Pair, AShooterCharacter* Pawn, APlayerController* Viewer)
+{
+	UWorld* World = GetWorld();
+
+	FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(LineOfSight), true, Viewer->GetPawn());
+	CollisionParams.AddIgnoredActor(Pawn);
+
+	CheckPoints.Reset();
+	Pawn->BuildPauseReplicationCheckPoints(CheckPoints);
+
+	for (const FVector& PointToTest : CheckPoints)
+	{
+		Pair.PendingTraces.Add(World->AsyncLineTraceByChannel(EAsyncTraceType::Test, PointToTest, Pair.ViewLocation, ECC_Visibility, CollisionParams));
+	}
+
+	Pair.PawnLocation = Pawn->GetActorLocation();
+
+	INC_DWORD_STAT_BY(STAT_ShooterVisibilityTraces, CheckPoints.Num());
+	return CheckPoints.Num();
+}
+
+bool UShooterVisibilityManager::NeedsUpdate(const FShooterVisibilityPair& Pair, const FVector& PawnLocation, const FVector& ViewLocation) const
+{
+	if (!Pair.bHasResult || GetWorld()->GetTimeSeconds() - Pair.UpdateTime > VisibilityMaxAge)
+	{
+		return true;
+	}
+
+	const float MoveThresholdSq = FMath::Square(VisibilityMoveThreshold);
+	return FVector::DistSquared(Pair.PawnLocation, PawnLocation) > MoveThresholdSq
+		|| FVector::DistSquared(Pair.ViewLocation, ViewLocation) > MoveThresholdSq;
+}
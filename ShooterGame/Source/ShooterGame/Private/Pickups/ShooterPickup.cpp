@@ -2,8 +2,12 @@
 
 #include "ShooterGame.h"
 #include "Pickups/ShooterPickup.h"
+#include "Pickups/ShooterPickupRegistry.h"
 #include "Particles/ParticleSystemComponent.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickups Spawned"), STAT_ShooterPickupsSpawned, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickups Reused"), STAT_ShooterPickupsReused, STATGROUP_Game);
+
 AShooterPickup::AShooterPickup(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	UCapsuleComponent* CollisionComp = ObjectInitializer.CreateDefaultSubobject<UCapsuleComponent>(this, TEXT("CollisionComp"));
@@ -22,6 +26,7 @@ AShooterPickup::AShooterPickup(const FObjectInitializer& ObjectInitializer) : Su
 	bCanRespawn = true;
 	RespawnTime = 2.0f;
 	bIsActive = false;
+	bIsPooled = false;
 	PickedUpBy = NULL;
 
 	SetRemoteRoleForBackwardsCompat(ROLE_SimulatedProxy);
@@ -32,29 +37,106 @@ void AShooterPickup::BeginPlay()
 {
 	Super::BeginPlay();
 
-	RespawnPickup();
+	// register on pickup registry (server only), removed again in EndPlay
+	UShooterPickupRegistry::UpdatePickup(this);
 
-	// register on pickup list (server only), don't care about unregistering (in FinishDestroy) - no streaming
-	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
-	if (GameMode)
+	// prewarmed pickups are parked before they begin play, clients receive them hidden
+	if (bIsPooled || IsHidden())
 	{
-		GameMode->LevelPickups.Add(this);
+		return;
 	}
+
+	INC_DWORD_STAT(STAT_ShooterPickupsSpawned);
+
+	RespawnPickup();
+
 	if (!bCanRespawn) 
 	{
 		GetWorldTimerManager().SetTimer(TimerHandle_RespawnPickup, this, &AShooterPickup::DestroyOnCooldown, RespawnTime, false);
 	}
 }
 
+void AShooterPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UShooterPickupRegistry::RemovePickup(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AShooterPickup::DestroyOnCooldown()
 {
 	if (!bCanRespawn)
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("In Respawn"), AmmoClips);
+		ReturnToPool();
+	}
+}
+
+void AShooterPickup::ReturnToPool()
+{
+	if (GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode == NULL || !GameMode->AddPickupToPool(this))
+	{
+		// just picked up and the pool is full: send the pickup to clients first, DestroyOnCooldown comes back here
+		if (GetWorldTimerManager().IsTimerActive(TimerHandle_RespawnPickup))
+		{
+			FlushNetDormancy();
+			return;
+		}
 
 		Destroy();
 		return;
 	}
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_RespawnPickup);
+
+	// PickedUpBy stays set until the pickup is reused, clients need it with the final bIsActive update to play the pickup sound
+	bIsPooled = true;
+	bIsActive = false;
+	UShooterPickupRegistry::UpdatePickup(this);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// send the parked state once, then stay dormant until reused
+	SetNetDormancy(DORM_DormantAll);
+	if (HasActorBegunPlay())
+	{
+		FlushNetDormancy();
+	}
+}
+
+void AShooterPickup::ReuseFromPool(const FTransform& SpawnTransform)
+{
+	INC_DWORD_STAT(STAT_ShooterPickupsReused);
+
+	// wake up while moving, dormancy routed actors are spatialized again at the new location when they go back to sleep
+	SetNetDormancy(DORM_Awake);
+
+	bIsPooled = false;
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	if (!bCanRespawn)
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_RespawnPickup, this, &AShooterPickup::DestroyOnCooldown, RespawnTime, false);
+	}
+
+	RespawnPickup();
+
+	// replicate the new location and state once, then stay dormant
+	if (bIsPooled || IsPendingKill())
+	{
+		// picked up and given back by RespawnPickup's overlap check
+		return;
+	}
+	SetNetDormancy(DORM_DormantAll);
+	FlushNetDormancy();
 }
 
 void AShooterPickup::NotifyActorBeginOverlap(class AActor* Other)
@@ -85,12 +167,18 @@ void AShooterPickup::PickupOnTouch(class AShooterCharacter* Pawn)
 			if (!IsPendingKill())
 			{
 				bIsActive = false;
+				UShooterPickupRegistry::UpdatePickup(this);
 				OnPickedUp();
 
 				if (RespawnTime > 0.0f && bCanRespawn)
 				{
 					GetWorldTimerManager().SetTimer(TimerHandle_RespawnPickup, this, &AShooterPickup::RespawnPickup, RespawnTime, false);
 				}
+				else if (!bCanRespawn)
+				{
+					// single use, give it back right away instead of waiting for the cooldown
+					ReturnToPool();
+				}
 			}
 		}
 	}
@@ -101,6 +189,7 @@ void AShooterPickup::RespawnPickup()
 	
 	bIsActive = true;
 	PickedUpBy = NULL;
+	UShooterPickupRegistry::UpdatePickup(this);
 	OnRespawned();
 
 	TSet<AActor*> OverlappingPawns;
@@ -0,0 +1,234 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Pickups/ShooterPickupRegistry.h"
+#include "Pickups/ShooterPickup.h"
+#include "NavigationSystem.h"
+
+/** grid cell size, pickups don't move so the grid is never rebuilt */
+static const float PickupGridCellSize = 2000.0f;
+
+static int32 PickupMaxPathTests = 3;
+FAutoConsoleVariableRef CVarPickupMaxPathTests(
+	TEXT("p.PickupMaxPathTests"),
+	PickupMaxPathTests,
+	TEXT("Max nearest pickups tested for a path before the query gives up."),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Pickups"), STAT_ShooterRegisteredPickups, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Queries"), STAT_ShooterPickupQueries, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Path Tests"), STAT_ShooterPickupPathTests, STATGROUP_Game);
+
+void UShooterPickupRegistry::UpdatePickup(AShooterPickup* Pickup)
+{
+	UWorld* World = Pickup ? Pickup->GetWorld() : nullptr;
+	UShooterPickupRegistry* PickupRegistry = World ? World->GetSubsystem<UShooterPickupRegistry>() : nullptr;
+	if (PickupRegistry == nullptr || !Pickup->HasAuthority())
+	{
+		return;
+	}
+
+	bool& bInGrid = PickupRegistry->Pickups.FindOrAdd(Pickup, false);
+	const bool bActive = Pickup->IsActive() && !Pickup->IsPendingKill();
+	if (bActive != bInGrid)
+	{
+		bInGrid = bActive;
+		if (bActive)
+		{
+			PickupRegistry->AddActivePickup(Pickup);
+		}
+		else
+		{
+			PickupRegistry->RemoveActivePickup(Pickup);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterRegisteredPickups, PickupRegistry->Pickups.Num());
+}
+
+void UShooterPickupRegistry::RemovePickup(AShooterPickup* Pickup)
+{
+	UWorld* World = Pickup ? Pickup->GetWorld() : nullptr;
+	UShooterPickupRegistry* PickupRegistry = World ? World->GetSubsystem<UShooterPickupRegistry>() : nullptr;
+	if (PickupRegistry == nullptr)
+	{
+		return;
+	}
+
+	bool bInGrid = false;
+	if (PickupRegistry->Pickups.RemoveAndCopyValue(Pickup, bInGrid) && bInGrid)
+	{
+		PickupRegistry->RemoveActivePickup(Pickup);
+	}
+
+	SET_DWORD_STAT(STAT_ShooterRegisteredPickups, PickupRegistry->Pickups.Num());
+}
+
+FIntPoint UShooterPickupRegistry::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / PickupGridCellSize), FMath::FloorToInt(Location.Y / PickupGridCellSize));
+}
+
+void UShooterPickupRegistry::AddActivePickup(AShooterPickup* Pickup)
+{
+	const FIntPoint Cell = GetCell(Pickup->GetActorLocation());
+	if (ActiveCells.Num() == 0)
+	{
+		MinCell = MaxCell = Cell;
+	}
+	else
+	{
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+	}
+
+	ActiveCells.FindOrAdd(Cell).Add(Pickup);
+	NumActivePerClass.FindOrAdd(Pickup->GetClass())++;
+}
+
+void UShooterPickupRegistry::RemoveActivePickup(AShooterPickup* Pickup)
+{
+	// search every cell, the pickup may have been moved since it was added
+	for (auto It = ActiveCells.CreateIterator(); It; ++It)
+	{
+		if (It.Value().RemoveSingleSwap(Pickup) > 0)
+		{
+			if (It.Value().Num() == 0)
+			{
+				It.RemoveCurrent();
+
+				MinCell = FIntPoint(MAX_int32, MAX_int32);
+				MaxCell = FIntPoint(MIN_int32, MIN_int32);
+				for (const auto& CellPair : ActiveCells)
+				{
+					MinCell = FIntPoint(FMath::Min(MinCell.X, CellPair.Key.X), FMath::Min(MinCell.Y, CellPair.Key.Y));
+					MaxCell = FIntPoint(FMath::Max(MaxCell.X, CellPair.Key.X), FMath::Max(MaxCell.Y, CellPair.Key.Y));
+				}
+			}
+			break;
+		}
+	}
+
+	int32* NumActive = NumActivePerClass.Find(Pickup->GetClass());
+	if (NumActive && --(*NumActive) <= 0)
+	{
+		NumActivePerClass.Remove(Pickup->GetClass());
+	}
+}
+
+AShooterPickup* UShooterPickupRegistry::FindNearestPickup(const FVector& Origin, TSubclassOf<AShooterPickup> PickupClass, TFunctionRef<bool(AShooterPickup*)> Filter, AController* PathQuerier) const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterPickupRegistry_FindNearestPickup);
+	INC_DWORD_STAT(STAT_ShooterPickupQueries);
+
+	if (ActiveCells.Num() == 0 || PickupClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	// skip the grid when nothing of the class is available
+	bool bHasActiveOfClass = false;
+	for (const auto& ClassPair : NumActivePerClass)
+	{
+		if (ClassPair.Key->IsChildOf(PickupClass))
+		{
+			bHasActiveOfClass = true;
+			break;
+		}
+	}
+
+	if (!bHasActiveOfClass)
+	{
+		return nullptr;
+	}
+
+	const FIntPoint OriginCell = GetCell(Origin);
+	const int32 MaxRing = FMath::Max(
+		FMath::Max(FMath::Abs(MinCell.X - OriginCell.X), FMath::Abs(MaxCell.X - OriginCell.X)),
+		FMath::Max(FMath::Abs(MinCell.Y - OriginCell.Y), FMath::Abs(MaxCell.Y - OriginCell.Y)));
+
+	// sorted furthest first, nearest is popped from the back
+	TArray<TPair<float, AShooterPickup*>, TInlineAllocator<16>> Candidates;
+	int32 NumPathTests = 0;
+
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		const int32 MinX = FMath::Max(OriginCell.X - Ring, MinCell.X);
+		const int32 MaxX = FMath::Min(OriginCell.X + Ring, MaxCell.X);
+		const int32 MinY = FMath::Max(OriginCell.Y - Ring, MinCell.Y);
+		const int32 MaxY = FMath::Min(OriginCell.Y + Ring, MaxCell.Y);
+
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			const bool bEdgeColumn = (FMath::Abs(X - OriginCell.X) == Ring);
+			for (int32 Y = MinY; Y <= MaxY; Y++)
+			{
+				if (!bEdgeColumn && FMath::Abs(Y - OriginCell.Y) != Ring)
+				{
+					continue;
+				}
+
+				const TArray<AShooterPickup*>* CellPickups = ActiveCells.Find(FIntPoint(X, Y));
+				if (CellPickups == nullptr)
+				{
+					continue;
+				}
+
+				for (AShooterPickup* Pickup : *CellPickups)
+				{
+					if (Pickup->IsA(PickupClass) && Filter(Pickup))
+					{
+						Candidates.Emplace(FVector::DistSquared(Pickup->GetActorLocation(), Origin), Pickup);
+					}
+				}
+			}
+		}
+
+		if (Candidates.Num() == 0)
+		{
+			continue;
+		}
+
+		Candidates.Sort([](const TPair<float, AShooterPickup*>& A, const TPair<float, AShooterPickup*>& B) { return A.Key > B.Key; });
+
+		// anything outside the visited rings is at least Ring cells away
+		const float SafeDistSq = (Ring == MaxRing) ? MAX_flt : FMath::Square(Ring * PickupGridCellSize);
+		while (Candidates.Num() > 0 && Candidates.Last().Key <= SafeDistSq)
+		{
+			AShooterPickup* Pickup = Candidates.Pop(false).Value;
+			if (PathQuerier == nullptr)
+			{
+				return Pickup;
+			}
+
+			if (NumPathTests >= PickupMaxPathTests)
+			{
+				return nullptr;
+			}
+
+			NumPathTests++;
+			if (IsReachable(PathQuerier, Origin, Pickup->GetActorLocation()))
+			{
+				return Pickup;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+bool UShooterPickupRegistry::IsReachable(AController* PathQuerier, const FVector& Origin, const FVector& Destination) const
+{
+	INC_DWORD_STAT(STAT_ShooterPickupPathTests);
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const ANavigationData* NavData = NavSys ? NavSys->GetNavDataForProps(PathQuerier->GetNavAgentPropertiesRef()) : nullptr;
+	if (NavData == nullptr)
+	{
+		// no navigation, don't block the query on it
+		return true;
+	}
+
+	FPathFindingQuery Query(PathQuerier, *NavData, Origin, Destination);
+	return NavSys->TestPathSync(Query, EPathFindingMode::Hierarchical);
+}
@@ -19,7 +19,8 @@ bool AShooterPickup_Ammo::IsForWeapon(UClass* WeaponClass)
 
 void AShooterPickup_Ammo::DroppedByPlayerDeath(AShooterWeapon* weapon)
 {
-	AmmoClips = weapon->GetCurrentAmmo() / weapon->GetAmmoPerClip();
+	// reused drops would otherwise keep the amount of their previous life
+	AmmoClips = weapon ? weapon->GetCurrentAmmo() / weapon->GetAmmoPerClip() : GetClass()->GetDefaultObject<AShooterPickup_Ammo>()->AmmoClips;
 	UE_LOG(LogTemp, Warning, TEXT("Ammo %d"), AmmoClips);
 
 }
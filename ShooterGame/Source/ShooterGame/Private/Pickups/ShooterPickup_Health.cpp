@@ -18,7 +18,7 @@ void AShooterPickup_Health::GivePickupTo(class AShooterCharacter* Pawn)
 {
 	if (Pawn)
 	{
-		Pawn->Health = FMath::Min(FMath::TruncToInt(Pawn->Health) + Health, Pawn->GetMaxHealth());
+		Pawn->SetHealth(FMath::Min(FMath::TruncToInt(Pawn->Health) + Health, Pawn->GetMaxHealth()));
 
 		// Fire event for collected health
 		const UWorld* World = GetWorld();
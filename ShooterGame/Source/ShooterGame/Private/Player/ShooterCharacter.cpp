@@ -2,14 +2,17 @@
 
 #include "ShooterGame.h"
 #include "ShooterCharacterMovement.h"
+#include "Player/ShooterHitboxComponent.h"
 #include "Weapons/ShooterWeapon.h"
 #include "Weapons/ShooterDamageType.h"
 #include "UI/ShooterHUD.h"
 #include "Online/ShooterPlayerState.h"
+#include "Online/ShooterVisibilityManager.h"
+#include "Player/ShooterRagdollManager.h"
+#include "Player/ShooterSignificanceManager.h"
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
 #include "Sound/SoundNodeLocalPlayer.h"
-#include "AudioThread.h"
 
 static int32 NetVisualizeRelevancyTestPoints = 0;
 FAutoConsoleVariableRef CVarNetVisualizeRelevancyTestPoints(
@@ -28,6 +31,28 @@ FAutoConsoleVariableRef CVarNetEnablePauseRelevancy(
 	TEXT("0: Disable, 1: Enable"),
 	ECVF_Cheat);
 
+static int32 NetUseVisibilityManager = 1;
+FAutoConsoleVariableRef CVarNetUseVisibilityManager(
+	TEXT("p.NetUseVisibilityManager"),
+	NetUseVisibilityManager,
+	TEXT("Pause relevancy reads cached async visibility instead of tracing for every pawn and connection.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static int32 PawnRecycling = 1;
+FAutoConsoleVariableRef CVarPawnRecycling(
+	TEXT("p.PawnRecycling"),
+	PawnRecycling,
+	TEXT("Park dead pawns in the game mode's pawn pool and reuse them on respawn instead of destroying them.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+/** how often health regen is applied while the cheat is on */
+static const float HealthRegenInterval = 0.1f;
+
+/** how often toggled running checks if the pawn stopped */
+static const float RunToggleCheckInterval = 0.1f;
+
 FOnShooterCharacterEquipWeapon AShooterCharacter::NotifyEquipWeapon;
 FOnShooterCharacterUnEquipWeapon AShooterCharacter::NotifyUnEquipWeapon;
 
@@ -59,15 +84,24 @@ AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer
 	GetCapsuleComponent()->SetCollisionResponseToChannel(COLLISION_PROJECTILE, ECR_Block);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(COLLISION_WEAPON, ECR_Ignore);
 
+	HitboxComponent = ObjectInitializer.CreateDefaultSubobject<UShooterHitboxComponent>(this, TEXT("Hitboxes"));
+
 	TargetingSpeedModifier = 0.5f;
 	bIsTargeting = false;
 	RunningSpeedModifier = 1.5f;
 	bWantsToRun = false;
 	bWantsToFire = false;
+	bIsPooled = false;
+	bPendingRecycle = false;
+	Significance = EShooterSignificance::Full;
+	LastCombatTime = 0.f;
 	LowHealthPercentage = 0.5f;
 
 	BaseTurnRate = 45.f;
 	BaseLookUpRate = 45.f;
+
+	// everything left in Tick is cosmetic, state changes are handled by timers and rep notifies
+	PrimaryActorTick.bAllowTickOnDedicatedServer = false;
 }
 
 void AShooterCharacter::PostInitializeComponents()
@@ -91,7 +125,11 @@ void AShooterCharacter::PostInitializeComponents()
 		MeshMIDs.Add(GetMesh()->CreateAndSetMaterialInstanceDynamic(iMat));
 	}
 
-	// play respawn effects
+	PlayRespawnEffects();
+}
+
+void AShooterCharacter::PlayRespawnEffects()
+{
 	if (GetNetMode() != NM_DedicatedServer)
 	{
 		if (RespawnFX)
@@ -125,6 +163,8 @@ void AShooterCharacter::PawnClientRestart()
 	// set team colors for 1st person view
 	UMaterialInstanceDynamic* Mesh1PMID = Mesh1P->CreateAndSetMaterialInstanceDynamic(0);
 	UpdateTeamColors(Mesh1PMID);
+
+	UpdateLocallyControlledSound();
 }
 
 void AShooterCharacter::PossessedBy(class AController* InController)
@@ -133,6 +173,25 @@ void AShooterCharacter::PossessedBy(class AController* InController)
 
 	// [server] as soon as PlayerState is assigned, set team colors of this pawn for local player
 	UpdateTeamColorsAllMIDs();
+
+	UpdateLocallyControlledSound();
+	UpdateHealthRegen();
+}
+
+void AShooterCharacter::UnPossessed()
+{
+	Super::UnPossessed();
+
+	UpdateLocallyControlledSound();
+	UpdateHealthRegen();
+}
+
+void AShooterCharacter::OnRep_Controller()
+{
+	Super::OnRep_Controller();
+
+	UpdateLocallyControlledSound();
+	UpdateHealthRegen();
 }
 
 void AShooterCharacter::OnRep_PlayerState()
@@ -190,6 +249,12 @@ void AShooterCharacter::UpdatePawnMeshes()
 
 	GetMesh()->VisibilityBasedAnimTickOption = bFirstPerson ? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered : EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
 	GetMesh()->SetOwnerNoSee(bFirstPerson);
+
+	// server hitboxes use baked poses, keep montages running for their timing but skip pose evaluation until death
+	if (HitboxComponent && HitboxComponent->ShouldSkipServerAnimation())
+	{
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
 }
 
 void AShooterCharacter::UpdateTeamColors(UMaterialInstanceDynamic* UseMID)
@@ -286,6 +351,8 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 		else
 		{
 			PlayHit(ActualDamage, DamageEvent, EventInstigator ? EventInstigator->GetPawn() : NULL, DamageCauser);
+			UpdateLowHealthSound();
+			UpdateHealthRegen();
 		}
 
 		MakeNoise(1.0f, EventInstigator ? EventInstigator->GetPawn() : this);
@@ -342,25 +409,23 @@ void AShooterCharacter::OnDeath(float KillingDamage, struct FDamageEvent const&
 	}
 
 	SetReplicatingMovement(false);
-	TearOff();
+
+	// pooled pawns keep their actor channel so they can be reused, everything else is handed over to the clients
+	bPendingRecycle = ShouldRecycleOnDeath();
+	if (!bPendingRecycle)
+	{
+		TearOff();
+	}
 	bIsDying = true;
 	
 	if (GetLocalRole() == ROLE_Authority)
 	{
-		// register on pickup list (server only), don't care about unregistering (in FinishDestroy) - no streaming
+		// dropped ammo comes from the pickup pool and registers itself on the pickup registry
 		AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
 		if (GameMode)
 		{
 			UE_LOG(LogTemp, Warning, TEXT("Weapon to drop %s"), CurrentWeapon->ammoDropType);
-			AActor* weaponActor = GetWorld()->SpawnActor<AActor>(CurrentWeapon->ammoDropType, GetActorLocation(), GetActorRotation());
-			if (weaponActor) {
-				AShooterPickup_Ammo* spawnedAmmo = Cast<AShooterPickup_Ammo>(weaponActor);
-				if (spawnedAmmo)
-				{
-					spawnedAmmo->DroppedByPlayerDeath(CurrentWeapon);
-					GameMode->LevelPickups.Add(spawnedAmmo);
-				}
-			}
+			GameMode->SpawnDroppedPickup(CurrentWeapon->ammoDropType, FTransform(GetActorRotation(), GetActorLocation()), CurrentWeapon);
 		}
 		ReplicateHit(KillingDamage, DamageEvent, PawnInstigator, DamageCauser, true);
 
@@ -439,6 +504,8 @@ void AShooterCharacter::OnDeath(float KillingDamage, struct FDamageEvent const&
 
 void AShooterCharacter::PlayHit(float DamageTaken, struct FDamageEvent const& DamageEvent, class APawn* PawnInstigator, class AActor* DamageCauser)
 {
+	NotifyCombatActivity();
+
 	if (GetLocalRole() == ROLE_Authority)
 	{
 		ReplicateHit(DamageTaken, DamageEvent, PawnInstigator, DamageCauser, false);
@@ -484,6 +551,7 @@ void AShooterCharacter::PlayHit(float DamageTaken, struct FDamageEvent const& Da
 void AShooterCharacter::SetRagdollPhysics()
 {
 	bool bInRagdoll = false;
+	bool bHoldingPose = false;
 
 	if (IsPendingKill())
 	{
@@ -493,6 +561,11 @@ void AShooterCharacter::SetRagdollPhysics()
 	{
 		bInRagdoll = false;
 	}
+	else if (!UShooterRagdollManager::RequestRagdoll(this))
+	{
+		// over budget, keep the body in its death pose
+		bHoldingPose = HoldDeathPose();
+	}
 	else
 	{
 		// initialize physics/etc
@@ -507,17 +580,149 @@ void AShooterCharacter::SetRagdollPhysics()
 	GetCharacterMovement()->DisableMovement();
 	GetCharacterMovement()->SetComponentTickEnabled(false);
 
-	if (!bInRagdoll)
+	const float BodyLifeSpan = (bInRagdoll || bHoldingPose) ? 10.0f : 1.0f;
+	if (!bInRagdoll && !bHoldingPose)
 	{
-		// hide and set short lifespan
-		TurnOff();
-		SetActorHiddenInGame(true);
-		SetLifeSpan(1.0f);
+		// hide and set short lifespan; pooled bodies aren't torn off, so hiding them would replicate and
+		// remove the corpse on every client at once; ReturnToPool hides them instead
+		if (!bPendingRecycle)
+		{
+			TurnOff();
+			SetActorHiddenInGame(true);
+		}
 	}
-	else
+
+	if (bPendingRecycle)
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_ReturnToPool, this, &AShooterCharacter::ReturnToPool, BodyLifeSpan, false);
+	}
+	else if (GetLocalRole() == ROLE_Authority || GetTearOff())
+	{
+		// clients only own the body once it has been torn off, pooled bodies are recycled by the server
+		SetLifeSpan(BodyLifeSpan);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Pawn pool
+
+bool AShooterCharacter::ShouldRecycleOnDeath() const
+{
+	if (PawnRecycling == 0 || GetLocalRole() != ROLE_Authority)
+	{
+		return false;
+	}
+
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	return GameMode && GameMode->CanPoolPawn(this);
+}
+
+void AShooterCharacter::ReturnToPool()
+{
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode == NULL || !GameMode->AddPawnToPool(this))
+	{
+		Destroy();
+		return;
+	}
+
+	ResetPooledState();
+
+	bIsPooled = true;
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+
+	// send the parked state once, then stop considering the pawn for replication until it is reused
+	ForceNetUpdate();
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AShooterCharacter::ReuseFromPool(const FTransform& SpawnTransform)
+{
+	SetNetDormancy(DORM_Awake);
+
+	TeleportTo(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, true);
+
+	bIsPooled = false;
+	ResetPooledState();
+
+	Health = GetMaxHealth();
+	UpdateLowHealthSound();
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	SetReplicatingMovement(true);
+
+	// pawn is already known to the replication graph, no need to wait a tick like PostInitializeComponents does
+	SpawnDefaultInventory();
+
+	PlayRespawnEffects();
+	ForceNetUpdate();
+}
+
+bool AShooterCharacter::IsPooled() const
+{
+	return bIsPooled;
+}
+
+void AShooterCharacter::OnRep_IsPooled()
+{
+	ResetPooledState();
+
+	if (!bIsPooled)
+	{
+		PlayRespawnEffects();
+	}
+}
+
+void AShooterCharacter::ResetPooledState()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	const AShooterCharacter* DefCharacter = GetClass()->GetDefaultObject<AShooterCharacter>();
+
+	// undo ragdoll and put the mesh back where the capsule expects it
+	USkeletalMeshComponent* DefMesh = DefCharacter->GetMesh();
+	UShooterRagdollManager::RemoveRagdoll(this);
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->bBlendPhysics = false;
+	GetMesh()->bNoSkeletonUpdate = false;
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+	GetMesh()->SetCollisionProfileName(DefMesh->GetCollisionProfileName());
+	GetMesh()->SetCollisionObjectType(DefMesh->GetCollisionObjectType());
+	GetMesh()->SetCollisionResponseToChannels(DefMesh->GetCollisionResponseToChannels());
+	GetMesh()->SetCollisionEnabled(DefMesh->GetCollisionEnabled());
+	GetMesh()->SetHiddenInGame(false, true);
+
+	UCapsuleComponent* DefCapsule = DefCharacter->GetCapsuleComponent();
+	GetCapsuleComponent()->SetCollisionResponseToChannels(DefCapsule->GetCollisionResponseToChannels());
+	GetCapsuleComponent()->SetCollisionEnabled(DefCapsule->GetCollisionEnabled());
+
+	StopAllAnimMontages();
+
+	UShooterCharacterMovement* movementComponent = Cast<UShooterCharacterMovement>(GetMovementComponent());
+	if (movementComponent)
 	{
-		SetLifeSpan(10.0f);
+		movementComponent->ResetAbilityState();
+		movementComponent->SetComponentTickEnabled(true);
+		movementComponent->SetMovementMode(movementComponent->DefaultLandMovementMode);
 	}
+
+	LastTakeHitInfo = FTakeHitInfo();
+	LastTakeHitTimeTimeout = 0.f;
+
+	bIsDying = false;
+	bPendingRecycle = false;
+	bIsTargeting = false;
+	bWantsToRun = false;
+	bWantsToRunToggled = false;
+	bWantsToFire = false;
+
+	UpdatePawnMeshes();
+	UpdateTeamColorsAllMIDs();
 }
 
 
@@ -677,9 +882,10 @@ void AShooterCharacter::ServerEquipWeapon_Implementation(AShooterWeapon* Weapon)
 	EquipWeapon(Weapon);
 }
 
-void AShooterCharacter::OnRep_CurrentWeapon(AShooterWeapon* LastWeapon)
+void AShooterCharacter::OnRep_Inventory()
 {
-	SetCurrentWeapon(CurrentWeapon, LastWeapon);
+	// equipped weapon may have been waiting for its inventory entry to be mapped
+	OnRep_WeaponSlot();
 }
 
 void AShooterCharacter::SetCurrentWeapon(AShooterWeapon* NewWeapon, AShooterWeapon* LastWeapon)
@@ -783,6 +989,16 @@ void AShooterCharacter::SetRunning(bool bNewRunning, bool bToggle)
 	bWantsToRun = bNewRunning;
 	bWantsToRunToggled = bNewRunning && bToggle;
 
+	// toggled running ends when the pawn stops or moves backwards
+	if (bWantsToRunToggled)
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_RunToggle, this, &AShooterCharacter::CheckRunToggle, RunToggleCheckInterval, true);
+	}
+	else
+	{
+		GetWorldTimerManager().ClearTimer(TimerHandle_RunToggle);
+	}
+
 	if (GetLocalRole() < ROLE_Authority)
 	{
 		ServerSetRunning(bNewRunning, bToggle);
@@ -1152,82 +1368,171 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
-	if (bWantsToRunToggled && !IsRunning())
+	// running toggle, health regen and low health sound are driven by timers and health changes, see UpdateHealthRegen
+	if (GEngine->UseSound() && Significance != EShooterSignificance::Minimal)
 	{
-		SetRunning(false, false);
+		UpdateRunSounds();
 	}
-	AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(Controller);
-	if (MyPC && MyPC->HasHealthRegen())
+
+	if (NetVisualizeRelevancyTestPoints == 1)
 	{
-		if (this->Health < this->GetMaxHealth())
+		TArray<FVector> PointsToTest;
+		BuildPauseReplicationCheckPoints(PointsToTest);
+
+		for (FVector PointToTest : PointsToTest)
 		{
-			this->Health += 5 * DeltaSeconds;
-			if (Health > this->GetMaxHealth())
-			{
-				Health = this->GetMaxHealth();
-			}
+			DrawDebugSphere(GetWorld(), PointToTest, 10.0f, 8, FColor::Red);
 		}
 	}
+}
+
+void AShooterCharacter::BeginDestroy()
+{
+	Super::BeginDestroy();
+
+	if (!GExitPurge)
+	{
+		USoundNodeLocalPlayer::RemoveLocallyControlled(GetUniqueID());
+	}
+}
+
+void AShooterCharacter::UpdateHealthRegen()
+{
+	AShooterPlayerController* MyPC = Cast<AShooterPlayerController>(Controller);
+	const bool bWantsRegen = MyPC && MyPC->HasHealthRegen() && IsAlive() && Health < GetMaxHealth();
+
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	if (!bWantsRegen)
+	{
+		TimerManager.ClearTimer(TimerHandle_HealthRegen);
+	}
+	else if (!TimerManager.IsTimerActive(TimerHandle_HealthRegen))
+	{
+		TimerManager.SetTimer(TimerHandle_HealthRegen, this, &AShooterCharacter::HealthRegenTimer, HealthRegenInterval, true);
+	}
+}
+
+void AShooterCharacter::HealthRegenTimer()
+{
+	SetHealth(FMath::Min(Health + 5.0f * HealthRegenInterval, (float)GetMaxHealth()));
+}
+
+void AShooterCharacter::UpdateLowHealthSound()
+{
+	if (LowHealthSound == nullptr || !GEngine->UseSound() || Significance == EShooterSignificance::Minimal)
+	{
+		return;
+	}
 
-	if (GEngine->UseSound())
+	const float LowHealth = GetMaxHealth() * LowHealthPercentage;
+	if ((Health > 0 && Health < LowHealth) && (!LowHealthWarningPlayer || !LowHealthWarningPlayer->IsPlaying()))
 	{
-		if (LowHealthSound)
+		LowHealthWarningPlayer = UGameplayStatics::SpawnSoundAttached(LowHealthSound, GetRootComponent(),
+			NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, true);
+		if (LowHealthWarningPlayer)
 		{
-			if ((this->Health > 0 && this->Health < this->GetMaxHealth() * LowHealthPercentage) && (!LowHealthWarningPlayer || !LowHealthWarningPlayer->IsPlaying()))
-			{
-				LowHealthWarningPlayer = UGameplayStatics::SpawnSoundAttached(LowHealthSound, GetRootComponent(),
-					NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, true);
-				if (LowHealthWarningPlayer)
-				{
-					LowHealthWarningPlayer->SetVolumeMultiplier(0.0f);
-				}
-			}
-			else if ((this->Health > this->GetMaxHealth() * LowHealthPercentage || this->Health < 0) && LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
-			{
-				LowHealthWarningPlayer->Stop();
-			}
-			if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
-			{
-				const float MinVolume = 0.3f;
-				const float VolumeMultiplier = (1.0f - (this->Health / (this->GetMaxHealth() * LowHealthPercentage)));
-				LowHealthWarningPlayer->SetVolumeMultiplier(MinVolume + (1.0f - MinVolume) * VolumeMultiplier);
-			}
+			LowHealthWarningPlayer->SetVolumeMultiplier(0.0f);
 		}
+	}
+	else if ((Health > LowHealth || Health <= 0) && LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
+	{
+		LowHealthWarningPlayer->Stop();
+	}
 
-		UpdateRunSounds();
+	if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
+	{
+		const float MinVolume = 0.3f;
+		const float VolumeMultiplier = (1.0f - (Health / LowHealth));
+		LowHealthWarningPlayer->SetVolumeMultiplier(MinVolume + (1.0f - MinVolume) * VolumeMultiplier);
 	}
+}
 
+void AShooterCharacter::CheckRunToggle()
+{
+	if (!IsRunning())
+	{
+		SetRunning(false, false);
+	}
+}
+
+void AShooterCharacter::UpdateLocallyControlledSound()
+{
 	const APlayerController* PC = Cast<APlayerController>(GetController());
 	const bool bLocallyControlled = (PC ? PC->IsLocalController() : false);
-	const uint32 UniqueID = GetUniqueID();
-	FAudioThread::RunCommandOnAudioThread([UniqueID, bLocallyControlled]()
-		{
-			USoundNodeLocalPlayer::GetLocallyControlledActorCache().Add(UniqueID, bLocallyControlled);
-		});
+	USoundNodeLocalPlayer::SetLocallyControlled(GetUniqueID(), bLocallyControlled);
+}
 
-	TArray<FVector> PointsToTest;
-	BuildPauseReplicationCheckPoints(PointsToTest);
+bool AShooterCharacter::HoldDeathPose()
+{
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (DeathAnim == nullptr || AnimInstance == nullptr || !AnimInstance->Montage_IsPlaying(DeathAnim))
+	{
+		return false;
+	}
 
-	if (NetVisualizeRelevancyTestPoints == 1)
+	// freeze right before the montage starts blending back to the idle pose
+	const float TimeLeft = DeathAnim->GetPlayLength() - AnimInstance->Montage_GetPosition(DeathAnim) - DeathAnim->BlendOut.GetBlendTime();
+	if (TimeLeft > 0.f)
 	{
-		for (FVector PointToTest : PointsToTest)
+		GetWorldTimerManager().SetTimer(TimerHandle_FreezeMeshPose, this, &AShooterCharacter::FreezeMeshPose, TimeLeft, false);
+	}
+	else
+	{
+		FreezeMeshPose();
+	}
+
+	return true;
+}
+
+void AShooterCharacter::FreezeMeshPose()
+{
+	USkeletalMeshComponent* DeadMesh = GetMesh();
+	if (DeadMesh->IsSimulatingPhysics())
+	{
+		DeadMesh->PutAllRigidBodiesToSleep();
+		DeadMesh->SetAllBodiesSimulatePhysics(false);
+	}
+
+	// keep the last pose, kinematic bodies follow it
+	DeadMesh->bNoSkeletonUpdate = true;
+}
+
+void AShooterCharacter::SetSignificance(EShooterSignificance::Type NewSignificance)
+{
+	if (Significance == NewSignificance)
+	{
+		return;
+	}
+
+	Significance = NewSignificance;
+
+	// Tick skips audio updates for minimal pawns, don't leave loops running
+	if (Significance == EShooterSignificance::Minimal)
+	{
+		if (RunLoopAC && RunLoopAC->IsActive())
 		{
-			DrawDebugSphere(GetWorld(), PointToTest, 10.0f, 8, FColor::Red);
+			RunLoopAC->Stop();
+		}
+
+		if (LowHealthWarningPlayer && LowHealthWarningPlayer->IsPlaying())
+		{
+			LowHealthWarningPlayer->Stop();
 		}
 	}
+	else
+	{
+		// low health sound isn't polled, restart it if health is still low
+		UpdateLowHealthSound();
+	}
 }
 
-void AShooterCharacter::BeginDestroy()
+void AShooterCharacter::NotifyCombatActivity()
 {
-	Super::BeginDestroy();
+	LastCombatTime = GetWorld()->GetTimeSeconds();
 
-	if (!GExitPurge)
+	if (Significance != EShooterSignificance::Full)
 	{
-		const uint32 UniqueID = GetUniqueID();
-		FAudioThread::RunCommandOnAudioThread([UniqueID]()
-			{
-				USoundNodeLocalPlayer::GetLocallyControlledActorCache().Remove(UniqueID);
-			});
+		UShooterSignificanceManager::ApplySignificance(this, EShooterSignificance::Full);
 	}
 }
 
@@ -1253,6 +1558,8 @@ void AShooterCharacter::PreReplication(IRepChangedPropertyTracker& ChangedProper
 {
 	Super::PreReplication(ChangedPropertyTracker);
 
+	UpdatePawnState();
+
 	// Only replicate this property for a short duration after it changes so join in progress players don't get spammed with fx when joining late
 	DOREPLIFETIME_ACTIVE_OVERRIDE(AShooterCharacter, LastTakeHitInfo, GetWorld() && GetWorld()->GetTimeSeconds() < LastTakeHitTimeTimeout);
 }
@@ -1261,18 +1568,92 @@ void AShooterCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >&
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	// only to local owner: weapon change requests are locally instigated, other clients don't need it
-	DOREPLIFETIME_CONDITION(AShooterCharacter, Inventory, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(AShooterCharacter, LastTakeHitInfo, COND_Custom);
 
-	// everyone except local owner: flag change is locally instigated
-	DOREPLIFETIME_CONDITION(AShooterCharacter, bIsTargeting, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AShooterCharacter, bWantsToRun, COND_SkipOwner);
+	// everyone: the weapon slot in PawnState is resolved through the inventory, which only changes on spawn and pickup
+	DOREPLIFETIME(AShooterCharacter, Inventory);
+	DOREPLIFETIME(AShooterCharacter, PawnState);
+	DOREPLIFETIME(AShooterCharacter, bIsPooled);
+}
 
-	DOREPLIFETIME_CONDITION(AShooterCharacter, LastTakeHitInfo, COND_Custom);
+void AShooterCharacter::UpdatePawnState()
+{
+	FShooterPawnRepState NewState;
+	NewState.Health = FShooterPawnRepState::PackHealth(Health, GetMaxHealth());
+	NewState.Flags = (bIsTargeting ? FShooterPawnRepState::Flag_Targeting : 0) | (bWantsToRun ? FShooterPawnRepState::Flag_Running : 0);
+
+	const int32 WeaponIndex = CurrentWeapon ? Inventory.IndexOfByKey(CurrentWeapon) : INDEX_NONE;
+	if (WeaponIndex != INDEX_NONE && WeaponIndex + 1 < (1 << SHOOTER_PAWN_WEAPON_SLOT_BITS))
+	{
+		NewState.WeaponSlot = WeaponIndex + 1;
+	}
 
-	// everyone
-	DOREPLIFETIME(AShooterCharacter, CurrentWeapon);
-	DOREPLIFETIME(AShooterCharacter, Health);
+	// unchanged values don't dirty the property
+	PawnState = NewState;
+}
+
+void AShooterCharacter::OnRep_PawnState(const FShooterPawnRepState& PreviousState)
+{
+	if (PawnState.Health != PreviousState.Health)
+	{
+		OnRep_Health();
+	}
+
+	const uint8 ChangedFlags = PawnState.Flags ^ PreviousState.Flags;
+	if (ChangedFlags & FShooterPawnRepState::Flag_Targeting)
+	{
+		OnRep_IsTargeting();
+	}
+	if (ChangedFlags & FShooterPawnRepState::Flag_Running)
+	{
+		OnRep_WantsToRun();
+	}
+
+	if (PawnState.WeaponSlot != PreviousState.WeaponSlot)
+	{
+		OnRep_WeaponSlot();
+	}
+}
+
+void AShooterCharacter::OnRep_Health()
+{
+	Health = FShooterPawnRepState::UnpackHealth(PawnState.Health, GetMaxHealth());
+
+	UpdateLowHealthSound();
+	UpdateHealthRegen();
+}
+
+void AShooterCharacter::OnRep_IsTargeting()
+{
+	// flag change is locally instigated, don't let a late update undo it
+	if (!IsLocallyControlled())
+	{
+		bIsTargeting = (PawnState.Flags & FShooterPawnRepState::Flag_Targeting) != 0;
+	}
+}
+
+void AShooterCharacter::OnRep_WantsToRun()
+{
+	if (!IsLocallyControlled())
+	{
+		bWantsToRun = (PawnState.Flags & FShooterPawnRepState::Flag_Running) != 0;
+	}
+}
+
+void AShooterCharacter::OnRep_WeaponSlot()
+{
+	const int32 WeaponIndex = (int32)PawnState.WeaponSlot - 1;
+	AShooterWeapon* NewWeapon = Inventory.IsValidIndex(WeaponIndex) ? Inventory[WeaponIndex] : nullptr;
+	if (WeaponIndex != INDEX_NONE && NewWeapon == nullptr)
+	{
+		// weapon isn't mapped yet, OnRep_Inventory tries again
+		return;
+	}
+
+	if (NewWeapon != CurrentWeapon)
+	{
+		SetCurrentWeapon(NewWeapon, CurrentWeapon);
+	}
 }
 
 bool AShooterCharacter::IsReplicationPausedForConnection(const FNetViewer& ConnectionOwnerNetViewer)
@@ -1282,6 +1663,12 @@ bool AShooterCharacter::IsReplicationPausedForConnection(const FNetViewer& Conne
 		APlayerController* PC = Cast<APlayerController>(ConnectionOwnerNetViewer.InViewer);
 		check(PC);
 
+		UShooterVisibilityManager* VisibilityManager = NetUseVisibilityManager ? GetWorld()->GetSubsystem<UShooterVisibilityManager>() : nullptr;
+		if (VisibilityManager)
+		{
+			return !VisibilityManager->IsVisible(this, PC);
+		}
+
 		FVector ViewLocation;
 		FRotator ViewRotation;
 		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
@@ -1371,6 +1758,14 @@ int32 AShooterCharacter::GetMaxHealth() const
 	return GetClass()->GetDefaultObject<AShooterCharacter>()->Health;
 }
 
+void AShooterCharacter::SetHealth(float NewHealth)
+{
+	Health = NewHealth;
+
+	UpdateLowHealthSound();
+	UpdateHealthRegen();
+}
+
 bool AShooterCharacter::IsAlive() const
 {
 	return Health > 0;
@@ -7,6 +7,7 @@
 #include "Engine/Classes/Engine/World.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Curves/CurveFloat.h"
+#include "Sound/ShooterAudioManager.h"
 #include "Engine/Classes/GameFramework/Controller.h"
 
 UShooterCharacterMovement::UShooterCharacterMovement()
@@ -51,6 +52,21 @@ void UShooterCharacterMovement::StartRewind()
 	SetRewind(true);
 }
 
+void UShooterCharacterMovement::ResetAbilityState()
+{
+	rewindTimeStampStack.Reset();
+	rewindLocationsStack.Reset();
+	rewindHealthTimestampStack.Reset();
+	rewindHealthStack.Reset();
+
+	rewindCooldown = 0.f;
+	teleportCooldown = 0.f;
+	rewindLerpCurrentTime = 0.f;
+
+	execSetRewind(false);
+	execSetTeleport(false, FVector::ZeroVector);
+}
+
 #pragma region Movement Mode Implementations
 
 // determine what custom mode to us
@@ -301,7 +317,7 @@ void UShooterCharacterMovement::ProcessTeleport()
 
 	if (GetPawnOwner()->IsLocallyControlled())
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), teleportSound, teleportDestination);
+		UShooterAudioManager::PlaySoundAtLocation(GetWorld(), teleportSound, teleportDestination, EShooterSoundCategory::Movement, GetPawnOwner());
 	}
 
 	if (GetOwner()->HasAuthority())
@@ -317,7 +333,7 @@ void UShooterCharacterMovement::MulticastPlayTeleportSound_Implementation(FVecto
 	//this should only execute on proxies
 	if (!GetPawnOwner()->IsLocallyControlled())
 	{
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), teleportSound, location);
+		UShooterAudioManager::PlaySoundAtLocation(GetWorld(), teleportSound, location, EShooterSoundCategory::Movement, GetPawnOwner());
 	}
 }
 #pragma endregion
@@ -0,0 +1,490 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Player/ShooterHitboxComponent.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "Player/ShooterHitboxPoseTable.h"
+#include "EngineUtils.h"
+
+/** pawn meshes pick their anim tick option from ShouldSkipServerAnimation, refresh them when it may change */
+static void OnServerAnimationCVarChanged(IConsoleVariable* Var)
+{
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+		if (World && World->IsGameWorld())
+		{
+			for (AShooterCharacter* Pawn : TActorRange<AShooterCharacter>(World))
+			{
+				Pawn->UpdatePawnMeshes();
+			}
+		}
+	}
+}
+
+static int32 ServerBakedHitboxPoses = 1;
+FAutoConsoleVariableRef CVarServerBakedHitboxPoses(
+	TEXT("p.ServerBakedHitboxPoses"),
+	ServerBakedHitboxPoses,
+	TEXT("Dedicated server places hitboxes from the baked pose table and skips 3rd person animation.\n")
+	TEXT("0: Disable, 1: Enable"),
+	FConsoleVariableDelegate::CreateStatic(&OnServerAnimationCVarChanged),
+	ECVF_Default);
+
+static int32 RecordHitboxPoses = 0;
+FAutoConsoleVariableRef CVarRecordHitboxPoses(
+	TEXT("p.RecordHitboxPoses"),
+	RecordHitboxPoses,
+	TEXT("Average evaluated hitbox poses of all pawns into their baked pose table. Use in PIE and save the table afterwards.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Cheat);
+
+static int32 MeasureHitboxPoseError = 0;
+FAutoConsoleVariableRef CVarMeasureHitboxPoseError(
+	TEXT("p.MeasureHitboxPoseError"),
+	MeasureHitboxPoseError,
+	TEXT("Keep evaluating animation and periodically log how far baked hitboxes are from the animated ones.\n")
+	TEXT("0: Disable, 1: Enable"),
+	FConsoleVariableDelegate::CreateStatic(&OnServerAnimationCVarChanged),
+	ECVF_Cheat);
+
+/** accumulated baked pose error, reported every HitboxPoseErrorReportInterval seconds */
+static float HitboxPoseErrorSum = 0.f;
+static float HitboxPoseErrorMax = 0.f;
+static int32 HitboxPoseErrorSamples = 0;
+static double HitboxPoseErrorLastReportTime = 0.0;
+static const double HitboxPoseErrorReportInterval = 10.0;
+
+/** true if the ray segment passes through the sphere */
+static bool RayHitsSphere(const FVector& Origin, const FVector& Direction, float MaxDistance, const FVector& Center, float Radius)
+{
+	const float DistanceToCenter = FMath::Clamp(FVector::DotProduct(Center - Origin, Direction), 0.f, MaxDistance);
+	return FVector::DistSquared(Origin + Direction * DistanceToCenter, Center) <= FMath::Square(Radius);
+}
+
+UShooterHitboxComponent::UShooterHitboxComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	// only ticks while recording or measuring poses
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+	PrimaryComponentTick.TickInterval = 0.1f;
+
+	MaxHitboxes = 12;
+	RadiusScale = 1.0f;
+	BakedPoses = NULL;
+	Bounds = FSphere(ForceInit);
+	LastUpdateFrame = 0;
+	MappedBakedBonesNum = INDEX_NONE;
+}
+
+void UShooterHitboxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SetComponentTickEnabled(BakedPoses != NULL);
+}
+
+void UShooterHitboxComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (RecordHitboxPoses != 0 || MeasureHitboxPoseError != 0)
+	{
+		UpdateHitboxes();
+	}
+}
+
+bool UShooterHitboxComponent::ShouldSkipServerAnimation() const
+{
+	const AShooterCharacter* MyCharacter = Cast<AShooterCharacter>(GetOwner());
+	return ServerBakedHitboxPoses == 1
+		&& MeasureHitboxPoseError == 0
+		&& BakedPoses != NULL
+		&& MyCharacter != NULL
+		&& !MyCharacter->bIsDying
+		&& GetNetMode() == NM_DedicatedServer;
+}
+
+void UShooterHitboxComponent::MapBakedBones()
+{
+	const int32 NumBakedBones = BakedPoses ? BakedPoses->BoneNames.Num() : 0;
+	if (MappedBakedBonesNum == NumBakedBones)
+	{
+		return;
+	}
+
+	MappedBakedBonesNum = NumBakedBones;
+	for (FShooterHitbox& Hitbox : Hitboxes)
+	{
+		Hitbox.BakedBoneIndex = BakedPoses ? BakedPoses->BoneNames.IndexOfByKey(Hitbox.BoneName) : INDEX_NONE;
+	}
+}
+
+void UShooterHitboxComponent::MeasureBakedPoseError()
+{
+	const AShooterCharacter* MyCharacter = Cast<AShooterCharacter>(GetOwner());
+	const FShooterHitboxPose* Pose = BakedPoses ? BakedPoses->FindPose(MyCharacter) : NULL;
+	if (Pose == NULL)
+	{
+		return;
+	}
+
+	MapBakedBones();
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		const FShooterHitbox& Hitbox = Hitboxes[i];
+		if (Pose->BoneTransforms.IsValidIndex(Hitbox.BakedBoneIndex))
+		{
+			const FVector BakedCenter = (Hitbox.LocalTransform * Pose->BoneTransforms[Hitbox.BakedBoneIndex]).GetLocation();
+			const FVector EvaluatedCenter = (Hitbox.LocalTransform * HitboxPose[i]).GetLocation();
+			const float Error = FVector::Dist(BakedCenter, EvaluatedCenter);
+
+			HitboxPoseErrorSum += Error;
+			HitboxPoseErrorMax = FMath::Max(HitboxPoseErrorMax, Error);
+			HitboxPoseErrorSamples++;
+		}
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (HitboxPoseErrorSamples > 0 && Now - HitboxPoseErrorLastReportTime > HitboxPoseErrorReportInterval)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Baked hitbox pose error: avg %.2f cm, max %.2f cm over %d samples"), HitboxPoseErrorSum / HitboxPoseErrorSamples, HitboxPoseErrorMax, HitboxPoseErrorSamples);
+
+		HitboxPoseErrorSum = 0.f;
+		HitboxPoseErrorMax = 0.f;
+		HitboxPoseErrorSamples = 0;
+		HitboxPoseErrorLastReportTime = Now;
+	}
+}
+
+USkeletalMeshComponent* UShooterHitboxComponent::GetHitboxMesh() const
+{
+	const ACharacter* MyCharacter = Cast<ACharacter>(GetOwner());
+	return MyCharacter ? MyCharacter->GetMesh() : NULL;
+}
+
+void UShooterHitboxComponent::BuildHitboxes()
+{
+	Hitboxes.Reset();
+	HitboxBoneNames.Reset();
+	MappedBakedBonesNum = INDEX_NONE;
+
+	USkeletalMeshComponent* Mesh = GetHitboxMesh();
+	UPhysicsAsset* PhysAsset = Mesh ? Mesh->GetPhysicsAsset() : NULL;
+	BuiltForPhysicsAsset = PhysAsset;
+	if (PhysAsset == NULL)
+	{
+		return;
+	}
+
+	for (const USkeletalBodySetup* BodySetup : PhysAsset->SkeletalBodySetups)
+	{
+		const int32 BoneIndex = BodySetup ? Mesh->GetBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+		if (BoneIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FShooterHitbox Hitbox;
+		Hitbox.BoneName = BodySetup->BoneName;
+		Hitbox.BoneIndex = BoneIndex;
+		Hitbox.PhysMaterial = BodySetup->PhysMaterial;
+
+		// one capsule per body is enough for hit registration, use the first usable primitive
+		if (BodySetup->AggGeom.SphylElems.Num() > 0)
+		{
+			const FKSphylElem& Sphyl = BodySetup->AggGeom.SphylElems[0];
+			Hitbox.LocalTransform = Sphyl.GetTransform();
+			Hitbox.Radius = Sphyl.Radius;
+			Hitbox.HalfLength = Sphyl.Length * 0.5f;
+		}
+		else if (BodySetup->AggGeom.SphereElems.Num() > 0)
+		{
+			const FKSphereElem& Sphere = BodySetup->AggGeom.SphereElems[0];
+			Hitbox.LocalTransform = Sphere.GetTransform();
+			Hitbox.Radius = Sphere.Radius;
+			Hitbox.HalfLength = 0.f;
+		}
+		else if (BodySetup->AggGeom.BoxElems.Num() > 0)
+		{
+			// fit a capsule along the box Z axis
+			const FKBoxElem& Box = BodySetup->AggGeom.BoxElems[0];
+			Hitbox.LocalTransform = Box.GetTransform();
+			Hitbox.Radius = 0.5f * FMath::Min(Box.X, Box.Y);
+			Hitbox.HalfLength = FMath::Max(0.f, 0.5f * Box.Z - Hitbox.Radius);
+		}
+		else
+		{
+			continue;
+		}
+
+		Hitbox.Radius *= RadiusScale;
+		Hitboxes.Add(Hitbox);
+	}
+
+	// keep the largest bodies
+	Hitboxes.Sort([](const FShooterHitbox& A, const FShooterHitbox& B)
+	{
+		return A.Radius * A.Radius * (A.Radius + A.HalfLength) > B.Radius * B.Radius * (B.Radius + B.HalfLength);
+	});
+
+	if (MaxHitboxes > 0 && Hitboxes.Num() > MaxHitboxes)
+	{
+		Hitboxes.SetNum(MaxHitboxes);
+	}
+
+	for (const FShooterHitbox& Hitbox : Hitboxes)
+	{
+		HitboxBoneNames.Add(Hitbox.BoneName);
+	}
+	HitboxPose.SetNum(Hitboxes.Num());
+
+	LastUpdateFrame = 0;
+}
+
+bool UShooterHitboxComponent::HasHitboxes()
+{
+	USkeletalMeshComponent* Mesh = GetHitboxMesh();
+	if (Mesh == NULL)
+	{
+		return false;
+	}
+
+	if (BuiltForPhysicsAsset.Get() != Mesh->GetPhysicsAsset())
+	{
+		BuildHitboxes();
+	}
+
+	return Hitboxes.Num() > 0;
+}
+
+void UShooterHitboxComponent::UpdateHitboxes()
+{
+	if (LastUpdateFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	USkeletalMeshComponent* Mesh = GetHitboxMesh();
+	if (Mesh == NULL)
+	{
+		return;
+	}
+
+	if (BuiltForPhysicsAsset.Get() != Mesh->GetPhysicsAsset())
+	{
+		BuildHitboxes();
+	}
+
+	LastUpdateFrame = GFrameCounter;
+
+	const AShooterCharacter* MyCharacter = Cast<AShooterCharacter>(GetOwner());
+
+	// rewinding pawns are hidden and can't be damaged
+	UShooterCharacterMovement* MoveComp = MyCharacter ? Cast<UShooterCharacterMovement>(MyCharacter->GetCharacterMovement()) : NULL;
+	if (MoveComp && MoveComp->IsRewinding())
+	{
+		for (FShooterHitbox& Hitbox : Hitboxes)
+		{
+			Hitbox.WorldRadius = 0.f;
+		}
+		Bounds = FSphere(ForceInit);
+		return;
+	}
+
+	const FShooterHitboxPose* BakedPose = NULL;
+	if (ShouldSkipServerAnimation())
+	{
+		BakedPose = BakedPoses->FindPose(MyCharacter);
+		MapBakedBones();
+	}
+
+	// bones missing from the baked pose, and recording or measuring, need the evaluated pose
+	bool bNeedsEvaluatedPose = BakedPose == NULL;
+	for (int32 i = 0; i < Hitboxes.Num() && !bNeedsEvaluatedPose; i++)
+	{
+		bNeedsEvaluatedPose = !BakedPose->BoneTransforms.IsValidIndex(Hitboxes[i].BakedBoneIndex);
+	}
+
+	// meshes that aren't rendered may not refresh their bones on their own, don't read a stale pose
+	if (bNeedsEvaluatedPose && !Mesh->ShouldUpdateTransform(false))
+	{
+		Mesh->RefreshBoneTransforms();
+	}
+
+	const TArray<FTransform>& ComponentSpaceTransforms = Mesh->GetComponentSpaceTransforms();
+
+	// component space pose of every hitbox bone, baked when available, evaluated otherwise
+	HitboxPose.SetNum(Hitboxes.Num());
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		const FShooterHitbox& Hitbox = Hitboxes[i];
+		if (BakedPose && BakedPose->BoneTransforms.IsValidIndex(Hitbox.BakedBoneIndex))
+		{
+			HitboxPose[i] = BakedPose->BoneTransforms[Hitbox.BakedBoneIndex];
+		}
+		else if (ComponentSpaceTransforms.IsValidIndex(Hitbox.BoneIndex))
+		{
+			HitboxPose[i] = ComponentSpaceTransforms[Hitbox.BoneIndex];
+		}
+		else
+		{
+			HitboxPose[i] = FTransform::Identity;
+		}
+	}
+
+	if (BakedPose == NULL && BakedPoses && MyCharacter && !MyCharacter->bIsDying && ComponentSpaceTransforms.Num() > 0)
+	{
+		if (RecordHitboxPoses != 0)
+		{
+			BakedPoses->RecordPose(MyCharacter, HitboxBoneNames, HitboxPose);
+		}
+
+		if (MeasureHitboxPoseError != 0)
+		{
+			MeasureBakedPoseError();
+		}
+	}
+
+	const FTransform& ComponentToWorld = Mesh->GetComponentTransform();
+	const float WorldScale = ComponentToWorld.GetMaximumAxisScale();
+
+	FBox BoundingBox(ForceInit);
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		FShooterHitbox& Hitbox = Hitboxes[i];
+		if (BakedPose == NULL && !ComponentSpaceTransforms.IsValidIndex(Hitbox.BoneIndex))
+		{
+			Hitbox.WorldRadius = 0.f;
+			continue;
+		}
+
+		const FTransform CapsuleToWorld = Hitbox.LocalTransform * HitboxPose[i] * ComponentToWorld;
+		const FVector Center = CapsuleToWorld.GetLocation();
+		const FVector HalfAxis = CapsuleToWorld.TransformVector(FVector(0.f, 0.f, Hitbox.HalfLength));
+
+		Hitbox.SegmentStart = Center - HalfAxis;
+		Hitbox.SegmentEnd = Center + HalfAxis;
+		Hitbox.WorldRadius = Hitbox.Radius * WorldScale;
+
+		const FVector RadiusExtent(Hitbox.WorldRadius);
+		BoundingBox += FBox(Hitbox.SegmentStart - RadiusExtent, Hitbox.SegmentStart + RadiusExtent);
+		BoundingBox += FBox(Hitbox.SegmentEnd - RadiusExtent, Hitbox.SegmentEnd + RadiusExtent);
+	}
+
+	Bounds = BoundingBox.IsValid ? FSphere(BoundingBox.GetCenter(), BoundingBox.GetExtent().Size()) : FSphere(ForceInit);
+}
+
+bool UShooterHitboxComponent::RaycastHitboxes(const FVector& Origin, const FVector& Direction, float MaxDistance, FHitResult& OutHit)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterHitboxComponent_RaycastHitboxes);
+
+	// reject rays that miss the mesh bounds before refreshing the pose, most pawns are nowhere near the shot
+	const USkeletalMeshComponent* Mesh = GetHitboxMesh();
+	if (Mesh == NULL || !RayHitsSphere(Origin, Direction, MaxDistance, Mesh->Bounds.Origin, Mesh->Bounds.SphereRadius * FMath::Max(1.f, RadiusScale)))
+	{
+		return false;
+	}
+
+	UpdateHitboxes();
+
+	if (Hitboxes.Num() == 0 || Bounds.W <= 0.f)
+	{
+		return false;
+	}
+
+	// reject rays that don't pass through the hitbox bounding sphere
+	if (!RayHitsSphere(Origin, Direction, MaxDistance, Bounds.Center, Bounds.W))
+	{
+		return false;
+	}
+
+	int32 BestIndex = INDEX_NONE;
+	float BestDistance = MaxDistance;
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		const FShooterHitbox& Hitbox = Hitboxes[i];
+		float HitDistance = 0.f;
+		if (Hitbox.WorldRadius > 0.f && IntersectRayCapsule(Origin, Direction, Hitbox.SegmentStart, Hitbox.SegmentEnd, Hitbox.WorldRadius, HitDistance) && HitDistance < BestDistance)
+		{
+			BestIndex = i;
+			BestDistance = HitDistance;
+		}
+	}
+
+	if (BestIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FShooterHitbox& BestHitbox = Hitboxes[BestIndex];
+	const FVector HitLocation = Origin + Direction * BestDistance;
+	const FVector ClosestOnSegment = FMath::ClosestPointOnSegment(HitLocation, BestHitbox.SegmentStart, BestHitbox.SegmentEnd);
+	const FVector HitNormal = (HitLocation - ClosestOnSegment).GetSafeNormal();
+
+	OutHit = FHitResult(GetOwner(), GetHitboxMesh(), HitLocation, HitNormal);
+	OutHit.TraceStart = Origin;
+	OutHit.TraceEnd = Origin + Direction * MaxDistance;
+	OutHit.Distance = BestDistance;
+	OutHit.Time = MaxDistance > 0.f ? BestDistance / MaxDistance : 0.f;
+	OutHit.BoneName = BestHitbox.BoneName;
+	OutHit.PhysMaterial = BestHitbox.PhysMaterial;
+	OutHit.Item = BestHitbox.BoneIndex;
+
+	return true;
+}
+
+bool UShooterHitboxComponent::IntersectRayCapsule(const FVector& Origin, const FVector& Direction, const FVector& SegmentStart, const FVector& SegmentEnd, float Radius, float& OutDistance)
+{
+	// fixed order of operations and no platform specific intrinsics, so the server resolves the same hit everywhere
+	const FVector Axis = SegmentEnd - SegmentStart;
+	const FVector StartToOrigin = Origin - SegmentStart;
+	const float AxisLenSq = FVector::DotProduct(Axis, Axis);
+	const float AxisDotDir = FVector::DotProduct(Axis, Direction);
+	const float AxisDotOrigin = FVector::DotProduct(Axis, StartToOrigin);
+	const float RadiusSq = Radius * Radius;
+
+	// infinite cylinder around the segment
+	bool bStartCap = true;
+	const float A = AxisLenSq - AxisDotDir * AxisDotDir;
+	if (A > KINDA_SMALL_NUMBER)
+	{
+		const float B = AxisLenSq * FVector::DotProduct(StartToOrigin, Direction) - AxisDotOrigin * AxisDotDir;
+		const float C = AxisLenSq * FVector::DotProduct(StartToOrigin, StartToOrigin) - AxisDotOrigin * AxisDotOrigin - RadiusSq * AxisLenSq;
+		const float H = B * B - A * C;
+		if (H < 0.f)
+		{
+			return false;
+		}
+
+		const float Distance = (-B - FMath::Sqrt(H)) / A;
+		const float AlongAxis = AxisDotOrigin + Distance * AxisDotDir;
+		if (AlongAxis > 0.f && AlongAxis < AxisLenSq)
+		{
+			OutDistance = Distance;
+			return Distance >= 0.f;
+		}
+
+		// missed the cylinder body, test the cap on the side we came in
+		bStartCap = AlongAxis <= 0.f;
+	}
+	else
+	{
+		// ray parallel to the axis (or sphere), enters through the cap it travels towards first
+		bStartCap = AxisDotDir >= 0.f;
+	}
+
+	const FVector CapToOrigin = bStartCap ? StartToOrigin : Origin - SegmentEnd;
+	const float B = FVector::DotProduct(Direction, CapToOrigin);
+	const float C = FVector::DotProduct(CapToOrigin, CapToOrigin) - RadiusSq;
+	const float H = B * B - C;
+	if (H < 0.f)
+	{
+		return false;
+	}
+
+	OutDistance = -B - FMath::Sqrt(H);
+	return OutDistance >= 0.f;
+}
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Player/ShooterHitboxPoseTable.h"
+
+/** samples after which recorded poses keep blending slowly instead of averaging forever */
+static const int32 MaxAveragedPoseSamples = 256;
+
+UShooterHitboxPoseTable::UShooterHitboxPoseTable(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PitchBuckets = 7;
+	YawBuckets = 3;
+	MaxAimYaw = 90.0f;
+}
+
+EHitboxMoveState::Type UShooterHitboxPoseTable::GetMoveState(const AShooterCharacter* Character)
+{
+	const UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+	if (MoveComp && MoveComp->IsFalling())
+	{
+		return EHitboxMoveState::Falling;
+	}
+
+	if (Character->IsRunning())
+	{
+		return EHitboxMoveState::Running;
+	}
+
+	return Character->GetVelocity().SizeSquared2D() > FMath::Square(10.0f) ? EHitboxMoveState::Moving : EHitboxMoveState::Idle;
+}
+
+int32 UShooterHitboxPoseTable::GetNumPoses() const
+{
+	return EHitboxMoveState::MAX * 2 * FMath::Max(1, PitchBuckets) * FMath::Max(1, YawBuckets);
+}
+
+int32 UShooterHitboxPoseTable::GetPoseIndex(EHitboxMoveState::Type MoveState, bool bCrouched, int32 PitchBucket, int32 YawBucket) const
+{
+	return ((MoveState * 2 + (bCrouched ? 1 : 0)) * FMath::Max(1, PitchBuckets) + PitchBucket) * FMath::Max(1, YawBuckets) + YawBucket;
+}
+
+int32 UShooterHitboxPoseTable::GetPoseIndex(const AShooterCharacter* Character, int32& OutPitchBucket) const
+{
+	const int32 NumPitch = FMath::Max(1, PitchBuckets);
+	const int32 NumYaw = FMath::Max(1, YawBuckets);
+
+	const FRotator AimOffsets = Character->GetAimOffsets();
+	const float PitchAlpha = (FMath::Clamp(AimOffsets.Pitch, -90.0f, 90.0f) + 90.0f) / 180.0f;
+	const float YawAlpha = MaxAimYaw > 0.f ? (FMath::Clamp(AimOffsets.Yaw, -MaxAimYaw, MaxAimYaw) + MaxAimYaw) / (2.0f * MaxAimYaw) : 0.5f;
+
+	OutPitchBucket = FMath::Clamp(FMath::RoundToInt(PitchAlpha * (NumPitch - 1)), 0, NumPitch - 1);
+	const int32 YawBucket = FMath::Clamp(FMath::RoundToInt(YawAlpha * (NumYaw - 1)), 0, NumYaw - 1);
+
+	return GetPoseIndex(GetMoveState(Character), Character->bIsCrouched, OutPitchBucket, YawBucket);
+}
+
+const FShooterHitboxPose* UShooterHitboxPoseTable::FindPose(const AShooterCharacter* Character) const
+{
+	int32 PitchBucket = 0;
+	const int32 PoseIndex = GetPoseIndex(Character, PitchBucket);
+	if (Poses.IsValidIndex(PoseIndex) && Poses[PoseIndex].NumSamples > 0)
+	{
+		return &Poses[PoseIndex];
+	}
+
+	// nothing recorded for this state, standing still with the same aim is closest
+	const int32 FallbackIndex = GetPoseIndex(EHitboxMoveState::Idle, Character->bIsCrouched, PitchBucket, FMath::Max(1, YawBuckets) / 2);
+	if (Poses.IsValidIndex(FallbackIndex) && Poses[FallbackIndex].NumSamples > 0)
+	{
+		return &Poses[FallbackIndex];
+	}
+
+	return NULL;
+}
+
+void UShooterHitboxPoseTable::RecordPose(const AShooterCharacter* Character, const TArray<FName>& InBoneNames, const TArray<FTransform>& InBoneTransforms)
+{
+	check(InBoneNames.Num() == InBoneTransforms.Num());
+
+	if (BoneNames != InBoneNames || Poses.Num() != GetNumPoses())
+	{
+		// bone set or layout changed, old entries are useless
+		BoneNames = InBoneNames;
+		Poses.Reset();
+		Poses.SetNum(GetNumPoses());
+	}
+
+	int32 PitchBucket = 0;
+	FShooterHitboxPose& Pose = Poses[GetPoseIndex(Character, PitchBucket)];
+	if (Pose.NumSamples == 0 || Pose.BoneTransforms.Num() != InBoneTransforms.Num())
+	{
+		Pose.BoneTransforms = InBoneTransforms;
+		Pose.NumSamples = 1;
+	}
+	else
+	{
+		Pose.NumSamples = FMath::Min(Pose.NumSamples + 1, MaxAveragedPoseSamples);
+
+		const float Alpha = 1.0f / Pose.NumSamples;
+		for (int32 i = 0; i < InBoneTransforms.Num(); i++)
+		{
+			FTransform& BoneTransform = Pose.BoneTransforms[i];
+			BoneTransform.SetLocation(FMath::Lerp(BoneTransform.GetLocation(), InBoneTransforms[i].GetLocation(), Alpha));
+			BoneTransform.SetRotation(FQuat::Slerp(BoneTransform.GetRotation(), InBoneTransforms[i].GetRotation(), Alpha));
+		}
+	}
+
+#if WITH_EDITOR
+	MarkPackageDirty();
+#endif
+}
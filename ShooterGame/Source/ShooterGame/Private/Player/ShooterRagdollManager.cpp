@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Player/ShooterRagdollManager.h"
+
+static int32 MaxRagdolls = 4;
+FAutoConsoleVariableRef CVarMaxRagdolls(
+	TEXT("p.MaxRagdolls"),
+	MaxRagdolls,
+	TEXT("Max corpses simulating physics at the same time, other deaths hold their death montage pose. Dedicated servers never simulate corpses."),
+	ECVF_Default);
+
+static float RagdollSettleSpeed = 20.0f;
+FAutoConsoleVariableRef CVarRagdollSettleSpeed(
+	TEXT("p.RagdollSettleSpeed"),
+	RagdollSettleSpeed,
+	TEXT("Ragdolls slower than this are considered settled."),
+	ECVF_Default);
+
+static float RagdollSettleTime = 0.5f;
+FAutoConsoleVariableRef CVarRagdollSettleTime(
+	TEXT("p.RagdollSettleTime"),
+	RagdollSettleTime,
+	TEXT("Seconds a ragdoll has to stay settled before it is frozen."),
+	ECVF_Default);
+
+static float RagdollMaxSimulationTime = 5.0f;
+FAutoConsoleVariableRef CVarRagdollMaxSimulationTime(
+	TEXT("p.RagdollMaxSimulationTime"),
+	RagdollMaxSimulationTime,
+	TEXT("Ragdolls are frozen after simulating this long, settled or not."),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Simulating Ragdolls"), STAT_ShooterRagdolls, STATGROUP_Game);
+
+bool UShooterRagdollManager::RequestRagdoll(AShooterCharacter* Character)
+{
+	UWorld* World = Character->GetWorld();
+	if (World->GetNetMode() == NM_DedicatedServer)
+	{
+		// nobody sees it
+		return false;
+	}
+
+	UShooterRagdollManager* RagdollManager = World->GetSubsystem<UShooterRagdollManager>();
+	if (RagdollManager == nullptr)
+	{
+		return true;
+	}
+
+	TArray<FShooterRagdoll>& Ragdolls = RagdollManager->Ragdolls;
+	if (Ragdolls.Num() >= MaxRagdolls)
+	{
+		if (MaxRagdolls <= 0)
+		{
+			return false;
+		}
+
+		// take over the least important ragdoll, as long as nobody sees it freeze
+		const float Score = RagdollManager->GetRagdollScore(Character);
+		int32 WorstIndex = INDEX_NONE;
+		float WorstScore = Score;
+		for (int32 i = 0; i < Ragdolls.Num(); i++)
+		{
+			const AShooterCharacter* Other = Ragdolls[i].Character.Get();
+			const float OtherScore = Other ? RagdollManager->GetRagdollScore(Other) : MAX_flt;
+			if (OtherScore > WorstScore && (Other == nullptr || !Other->GetMesh()->WasRecentlyRendered(0.2f)))
+			{
+				WorstIndex = i;
+				WorstScore = OtherScore;
+			}
+		}
+
+		if (WorstIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		if (AShooterCharacter* Other = Ragdolls[WorstIndex].Character.Get())
+		{
+			Other->FreezeMeshPose();
+		}
+		Ragdolls.RemoveAtSwap(WorstIndex);
+	}
+
+	FShooterRagdoll& Ragdoll = Ragdolls.AddDefaulted_GetRef();
+	Ragdoll.Character = Character;
+	Ragdoll.StartTime = World->GetTimeSeconds();
+	Ragdoll.SettledTime = 0.f;
+
+	SET_DWORD_STAT(STAT_ShooterRagdolls, Ragdolls.Num());
+	return true;
+}
+
+void UShooterRagdollManager::RemoveRagdoll(AShooterCharacter* Character)
+{
+	UWorld* World = Character->GetWorld();
+	UShooterRagdollManager* RagdollManager = World ? World->GetSubsystem<UShooterRagdollManager>() : nullptr;
+	if (RagdollManager)
+	{
+		RagdollManager->Ragdolls.RemoveAllSwap([Character](const FShooterRagdoll& Ragdoll) { return Ragdoll.Character == Character; });
+		SET_DWORD_STAT(STAT_ShooterRagdolls, RagdollManager->Ragdolls.Num());
+	}
+}
+
+void UShooterRagdollManager::Tick(float DeltaTime)
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	for (int32 i = Ragdolls.Num() - 1; i >= 0; i--)
+	{
+		FShooterRagdoll& Ragdoll = Ragdolls[i];
+		AShooterCharacter* Character = Ragdoll.Character.Get();
+		USkeletalMeshComponent* DeadMesh = Character ? Character->GetMesh() : nullptr;
+		if (DeadMesh == nullptr || Character->IsPendingKill())
+		{
+			Ragdolls.RemoveAtSwap(i);
+			continue;
+		}
+
+		// ragdoll starts simulating after this frame's SetRagdollPhysics, nothing to measure yet
+		if (!DeadMesh->IsSimulatingPhysics())
+		{
+			continue;
+		}
+
+		const bool bSettled = !DeadMesh->RigidBodyIsAwake() || DeadMesh->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(RagdollSettleSpeed);
+		Ragdoll.SettledTime = bSettled ? Ragdoll.SettledTime + DeltaTime : 0.f;
+
+		if (Ragdoll.SettledTime >= RagdollSettleTime || TimeSeconds - Ragdoll.StartTime >= RagdollMaxSimulationTime)
+		{
+			Character->FreezeMeshPose();
+			Ragdolls.RemoveAtSwap(i);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterRagdolls, Ragdolls.Num());
+}
+
+float UShooterRagdollManager::GetRagdollScore(const AShooterCharacter* Character) const
+{
+	float MinDistance = MAX_flt;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			MinDistance = FMath::Min(MinDistance, FVector::Dist(PC->PlayerCameraManager->GetCameraLocation(), Character->GetActorLocation()));
+		}
+	}
+
+	// off screen corpses count as much further away
+	return Character->GetMesh()->WasRecentlyRendered(0.2f) ? MinDistance : MinDistance * 4.0f;
+}
+
+bool UShooterRagdollManager::IsTickable() const
+{
+	return Ragdolls.Num() > 0;
+}
+
+ETickableTickType UShooterRagdollManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterRagdollManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterRagdollManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterRagdollManager, STATGROUP_Tickables);
+}
@@ -0,0 +1,193 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Player/ShooterSignificanceManager.h"
+#include "EngineUtils.h"
+
+static int32 PawnSignificance = 1;
+FAutoConsoleVariableRef CVarPawnSignificance(
+	TEXT("p.PawnSignificance"),
+	PawnSignificance,
+	TEXT("Throttle tick, animation and audio of remote pawns that are far, off screen and out of combat.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float PawnSignificanceNearDistance = 2000.0f;
+FAutoConsoleVariableRef CVarPawnSignificanceNearDistance(
+	TEXT("p.PawnSignificanceNearDistance"),
+	PawnSignificanceNearDistance,
+	TEXT("Remote pawns closer than this are never minimal, and full when on screen."),
+	ECVF_Default);
+
+static float PawnSignificanceFullScreenSize = 0.05f;
+FAutoConsoleVariableRef CVarPawnSignificanceFullScreenSize(
+	TEXT("p.PawnSignificanceFullScreenSize"),
+	PawnSignificanceFullScreenSize,
+	TEXT("Screen size (bounds radius relative to half screen width) above which rendered pawns are full."),
+	ECVF_Default);
+
+static float PawnSignificanceCombatTime = 3.0f;
+FAutoConsoleVariableRef CVarPawnSignificanceCombatTime(
+	TEXT("p.PawnSignificanceCombatTime"),
+	PawnSignificanceCombatTime,
+	TEXT("Seconds a pawn stays full after firing or getting hit."),
+	ECVF_Default);
+
+static float ReducedPawnTickInterval = 0.05f;
+FAutoConsoleVariableRef CVarReducedPawnTickInterval(
+	TEXT("p.ReducedPawnTickInterval"),
+	ReducedPawnTickInterval,
+	TEXT("Actor tick interval of reduced remote pawns."),
+	ECVF_Default);
+
+static float ReducedPawnAnimInterval = 0.033f;
+FAutoConsoleVariableRef CVarReducedPawnAnimInterval(
+	TEXT("p.ReducedPawnAnimInterval"),
+	ReducedPawnAnimInterval,
+	TEXT("Mesh tick interval of reduced remote pawns."),
+	ECVF_Default);
+
+static float MinimalPawnTickInterval = 0.25f;
+FAutoConsoleVariableRef CVarMinimalPawnTickInterval(
+	TEXT("p.MinimalPawnTickInterval"),
+	MinimalPawnTickInterval,
+	TEXT("Actor and mesh tick interval of minimal remote pawns. Their run and low health sounds are stopped."),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawns Full"), STAT_ShooterPawnsFull, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawns Reduced"), STAT_ShooterPawnsReduced, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pawns Minimal"), STAT_ShooterPawnsMinimal, STATGROUP_Game);
+
+void UShooterSignificanceManager::ApplySignificance(AShooterCharacter* Character, EShooterSignificance::Type Significance)
+{
+	float ActorInterval = 0.f;
+	float MeshInterval = 0.f;
+
+	switch (Significance)
+	{
+		case EShooterSignificance::Reduced:	ActorInterval = ReducedPawnTickInterval; MeshInterval = ReducedPawnAnimInterval; break;
+		case EShooterSignificance::Minimal:	ActorInterval = MinimalPawnTickInterval; MeshInterval = MinimalPawnTickInterval; break;
+		default:							break;
+	}
+
+	Character->SetActorTickInterval(ActorInterval);
+	Character->GetMesh()->SetComponentTickInterval(MeshInterval);
+	Character->SetSignificance(Significance);
+}
+
+void UShooterSignificanceManager::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterSignificanceManager_Tick);
+
+	UWorld* World = GetWorld();
+
+	if (!PawnSignificance)
+	{
+		if (bHasThrottledPawns)
+		{
+			bHasThrottledPawns = false;
+			for (AShooterCharacter* Character : TActorRange<AShooterCharacter>(World))
+			{
+				if (Character->GetSignificance() != EShooterSignificance::Full)
+				{
+					ApplySignificance(Character, EShooterSignificance::Full);
+				}
+			}
+		}
+		return;
+	}
+
+	TArray<FSignificanceView, TInlineAllocator<4>> Views;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			FSignificanceView& View = Views.AddDefaulted_GetRef();
+			View.Location = PC->PlayerCameraManager->GetCameraLocation();
+			View.TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(FMath::Max(1.0f, PC->PlayerCameraManager->GetFOVAngle()) * 0.5f));
+			View.ViewTarget = PC->GetViewTarget();
+		}
+	}
+
+	int32 NumPerLevel[3] = { 0, 0, 0 };
+
+	for (AShooterCharacter* Character : TActorRange<AShooterCharacter>(World))
+	{
+		// only remote pawns on clients, authority needs full rate poses for hit detection
+		if (Character->GetLocalRole() != ROLE_SimulatedProxy)
+		{
+			continue;
+		}
+
+		const EShooterSignificance::Type NewSignificance = Views.Num() > 0 ? CalcSignificance(Character, Views) : EShooterSignificance::Full;
+		if (NewSignificance != Character->GetSignificance())
+		{
+			ApplySignificance(Character, NewSignificance);
+		}
+
+		bHasThrottledPawns |= (NewSignificance != EShooterSignificance::Full);
+		NumPerLevel[NewSignificance]++;
+	}
+
+	SET_DWORD_STAT(STAT_ShooterPawnsFull, NumPerLevel[EShooterSignificance::Full]);
+	SET_DWORD_STAT(STAT_ShooterPawnsReduced, NumPerLevel[EShooterSignificance::Reduced]);
+	SET_DWORD_STAT(STAT_ShooterPawnsMinimal, NumPerLevel[EShooterSignificance::Minimal]);
+}
+
+EShooterSignificance::Type UShooterSignificanceManager::CalcSignificance(const AShooterCharacter* Character, const TArray<FSignificanceView, TInlineAllocator<4>>& Views) const
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	if (Character->GetLastCombatTime() > 0.f && TimeSeconds - Character->GetLastCombatTime() < PawnSignificanceCombatTime)
+	{
+		return EShooterSignificance::Full;
+	}
+
+	const FVector Location = Character->GetActorLocation();
+	const float BoundsRadius = Character->GetMesh()->Bounds.SphereRadius;
+	const bool bRendered = Character->GetMesh()->WasRecentlyRendered(0.2f);
+
+	float MaxScreenSize = 0.f;
+	float MinDistance = MAX_flt;
+	for (const FSignificanceView& View : Views)
+	{
+		if (View.ViewTarget == Character)
+		{
+			// spectating this pawn
+			return EShooterSignificance::Full;
+		}
+
+		const float Distance = FVector::Dist(View.Location, Location);
+		MinDistance = FMath::Min(MinDistance, Distance);
+		MaxScreenSize = FMath::Max(MaxScreenSize, BoundsRadius / FMath::Max(1.0f, Distance * View.TanHalfFOV));
+	}
+
+	const bool bNear = MinDistance < PawnSignificanceNearDistance;
+	if (bRendered && (bNear || MaxScreenSize >= PawnSignificanceFullScreenSize))
+	{
+		return EShooterSignificance::Full;
+	}
+
+	return (bRendered || bNear) ? EShooterSignificance::Reduced : EShooterSignificance::Minimal;
+}
+
+bool UShooterSignificanceManager::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_DedicatedServer;
+}
+
+ETickableTickType UShooterSignificanceManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterSignificanceManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterSignificanceManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSignificanceManager, STATGROUP_Tickables);
+}
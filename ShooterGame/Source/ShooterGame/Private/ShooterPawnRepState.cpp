@@ -0,0 +1,41 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterTypes.h"
+
+bool FShooterPawnRepState::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 PackedHealth = Health;
+	Ar.SerializeInt(PackedHealth, SHOOTER_PAWN_HEALTH_MAX + 1);
+
+	uint8 PackedFlags = Flags;
+	Ar.SerializeBits(&PackedFlags, Num_Flags);
+
+	uint8 PackedSlot = WeaponSlot;
+	Ar.SerializeBits(&PackedSlot, SHOOTER_PAWN_WEAPON_SLOT_BITS);
+
+	if (Ar.IsLoading())
+	{
+		Health = (uint16)PackedHealth;
+		Flags = PackedFlags;
+		WeaponSlot = PackedSlot;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+uint16 FShooterPawnRepState::PackHealth(float Health, float MaxHealth)
+{
+	if (Health <= 0.f || MaxHealth <= 0.f)
+	{
+		return 0;
+	}
+
+	return (uint16)FMath::Clamp(FMath::CeilToInt(Health / MaxHealth * SHOOTER_PAWN_HEALTH_MAX), 1, SHOOTER_PAWN_HEALTH_MAX);
+}
+
+float FShooterPawnRepState::UnpackHealth(uint16 PackedHealth, float MaxHealth)
+{
+	return (float)PackedHealth / SHOOTER_PAWN_HEALTH_MAX * MaxHealth;
+}
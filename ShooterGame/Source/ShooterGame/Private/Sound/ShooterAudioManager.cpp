@@ -0,0 +1,220 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Sound/ShooterAudioManager.h"
+
+static int32 GameplayAudioBudget = 1;
+FAutoConsoleVariableRef CVarGameplayAudioBudget(
+	TEXT("p.GameplayAudioBudget"),
+	GameplayAudioBudget,
+	TEXT("Merge, cull and budget gameplay one shot sounds at the end of the frame.\n")
+	TEXT("0: Play immediately, 1: Enable"),
+	ECVF_Default);
+
+static float SoundMergeDistance = 150.0f;
+FAutoConsoleVariableRef CVarSoundMergeDistance(
+	TEXT("p.SoundMergeDistance"),
+	SoundMergeDistance,
+	TEXT("Requests of the same sound closer than this in one frame play once."),
+	ECVF_Default);
+
+static int32 MaxNewSoundsPerFrame = 8;
+FAutoConsoleVariableRef CVarMaxNewSoundsPerFrame(
+	TEXT("p.MaxNewSoundsPerFrame"),
+	MaxNewSoundsPerFrame,
+	TEXT("Max gameplay sounds started per frame, closest first. 0: unlimited"),
+	ECVF_Default);
+
+static int32 MaxSoundVoices[EShooterSoundCategory::MAX] = { 12, 8, 4, 4 };
+FAutoConsoleVariableRef CVarMaxWeaponVoices(
+	TEXT("p.MaxWeaponVoices"),
+	MaxSoundVoices[EShooterSoundCategory::Weapon],
+	TEXT("Max playing gunfire sounds."),
+	ECVF_Default);
+FAutoConsoleVariableRef CVarMaxImpactVoices(
+	TEXT("p.MaxImpactVoices"),
+	MaxSoundVoices[EShooterSoundCategory::Impact],
+	TEXT("Max playing impact sounds."),
+	ECVF_Default);
+FAutoConsoleVariableRef CVarMaxExplosionVoices(
+	TEXT("p.MaxExplosionVoices"),
+	MaxSoundVoices[EShooterSoundCategory::Explosion],
+	TEXT("Max playing explosion sounds."),
+	ECVF_Default);
+FAutoConsoleVariableRef CVarMaxMovementVoices(
+	TEXT("p.MaxMovementVoices"),
+	MaxSoundVoices[EShooterSoundCategory::Movement],
+	TEXT("Max playing movement ability sounds."),
+	ECVF_Default);
+
+/** voices are counted for at most this long, looping or very long sounds shouldn't hold a slot forever */
+static const float MaxVoiceTrackTime = 5.0f;
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Played"), STAT_ShooterSoundsPlayed, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Merged"), STAT_ShooterSoundsMerged, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Culled"), STAT_ShooterSoundsCulled, STATGROUP_Game);
+
+void UShooterAudioManager::PlaySoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location, EShooterSoundCategory::Type Category, AActor* OwningActor)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (World == nullptr || Sound == nullptr || !GEngine->UseSound() || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	UShooterAudioManager* AudioManager = GameplayAudioBudget ? World->GetSubsystem<UShooterAudioManager>() : nullptr;
+	if (AudioManager == nullptr)
+	{
+		UGameplayStatics::PlaySoundAtLocation(World, Sound, Location, FRotator::ZeroRotator, 1.f, 1.f, 0.f, nullptr, nullptr, OwningActor);
+		return;
+	}
+
+	const float DistanceSq = AudioManager->GetListenerDistanceSq(Location);
+	const float MaxDistance = Sound->GetMaxDistance();
+	if (MaxDistance < WORLD_MAX && DistanceSq > FMath::Square(MaxDistance))
+	{
+		// would be culled by the audio mixer anyway
+		INC_DWORD_STAT(STAT_ShooterSoundsCulled);
+		return;
+	}
+
+	const APawn* OwningPawn = Cast<APawn>(OwningActor);
+
+	FShooterSoundRequest& Request = AudioManager->PendingRequests.AddDefaulted_GetRef();
+	Request.Sound = Sound;
+	Request.OwningActor = OwningActor;
+	Request.Location = Location;
+	Request.DistanceSq = DistanceSq;
+	Request.Category = Category;
+	Request.bLocal = OwningPawn && OwningPawn->IsLocallyControlled();
+}
+
+void UShooterAudioManager::Tick(float DeltaTime)
+{
+	ExpireVoices();
+	FlushRequests();
+}
+
+void UShooterAudioManager::FlushRequests()
+{
+	if (PendingRequests.Num() == 0)
+	{
+		return;
+	}
+
+	// closest first, merged requests collapse into the closest one
+	PendingRequests.Sort([](const FShooterSoundRequest& A, const FShooterSoundRequest& B)
+	{
+		return A.DistanceSq < B.DistanceSq;
+	});
+
+	UWorld* World = GetWorld();
+	const float TimeSeconds = World->GetTimeSeconds();
+	const float MergeDistanceSq = FMath::Square(SoundMergeDistance);
+
+	int32 NumPlayed = 0;
+	for (int32 i = 0; i < PendingRequests.Num(); i++)
+	{
+		const FShooterSoundRequest& Request = PendingRequests[i];
+		USoundBase* Sound = Request.Sound.Get();
+		if (Sound == nullptr)
+		{
+			continue;
+		}
+
+		bool bMerged = false;
+		for (int32 j = 0; j < i; j++)
+		{
+			const FShooterSoundRequest& Played = PendingRequests[j];
+			if (Played.Sound == Request.Sound && (Played.bLocal == Request.bLocal && (!Request.bLocal || Played.OwningActor == Request.OwningActor))
+				&& FVector::DistSquared(Played.Location, Request.Location) < MergeDistanceSq)
+			{
+				bMerged = true;
+				break;
+			}
+		}
+
+		if (bMerged)
+		{
+			INC_DWORD_STAT(STAT_ShooterSoundsMerged);
+			continue;
+		}
+
+		TArray<float>& Voices = VoiceEndTimes[Request.Category];
+		const bool bOverFrameBudget = MaxNewSoundsPerFrame > 0 && NumPlayed >= MaxNewSoundsPerFrame;
+		const bool bOverVoiceBudget = Voices.Num() >= MaxSoundVoices[Request.Category];
+
+		// locally controlled sounds are always heard
+		if (!Request.bLocal && (bOverFrameBudget || bOverVoiceBudget))
+		{
+			INC_DWORD_STAT(STAT_ShooterSoundsCulled);
+			continue;
+		}
+
+		UGameplayStatics::PlaySoundAtLocation(World, Sound, Request.Location, FRotator::ZeroRotator, 1.f, 1.f, 0.f, nullptr, nullptr, Request.OwningActor.Get());
+		Voices.Add(TimeSeconds + FMath::Min(Sound->GetDuration(), MaxVoiceTrackTime));
+		NumPlayed++;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ShooterSoundsPlayed, NumPlayed);
+	PendingRequests.Reset();
+}
+
+void UShooterAudioManager::ExpireVoices()
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	for (TArray<float>& Voices : VoiceEndTimes)
+	{
+		Voices.RemoveAllSwap([TimeSeconds](float EndTime) { return EndTime <= TimeSeconds; });
+	}
+}
+
+float UShooterAudioManager::GetListenerDistanceSq(const FVector& Location) const
+{
+	float BestDistanceSq = MAX_flt;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ListenerLocation, FrontDir, RightDir;
+			PC->GetAudioListenerPosition(ListenerLocation, FrontDir, RightDir);
+			BestDistanceSq = FMath::Min(BestDistanceSq, FVector::DistSquared(ListenerLocation, Location));
+		}
+	}
+
+	return BestDistanceSq;
+}
+
+bool UShooterAudioManager::IsTickable() const
+{
+	if (PendingRequests.Num() > 0)
+	{
+		return true;
+	}
+
+	for (const TArray<float>& Voices : VoiceEndTimes)
+	{
+		if (Voices.Num() > 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+ETickableTickType UShooterAudioManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UShooterAudioManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UShooterAudioManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterAudioManager, STATGROUP_Tickables);
+}
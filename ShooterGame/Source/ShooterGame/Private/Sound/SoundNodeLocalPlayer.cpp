@@ -3,11 +3,38 @@
 #include "ShooterGame.h"
 #include "Sound/SoundNodeLocalPlayer.h"
 #include "SoundDefinitions.h"
+#include "AudioThread.h"
 
 #define LOCTEXT_NAMESPACE "SoundNodeLocalPlayer"
 
 TMap<uint32, bool> USoundNodeLocalPlayer::LocallyControlledActorCache;
 
+/** game thread copy of LocallyControlledActorCache, used to detect changes */
+static TMap<uint32, bool> GameThreadLocallyControlledActors;
+
+/** state change waiting for the end of frame */
+struct FLocallyControlledUpdate
+{
+	uint32 ActorID;
+	bool bLocallyControlled;
+	bool bRemove;
+};
+
+/** changes waiting for the end of frame, in order */
+static TArray<FLocallyControlledUpdate> PendingLocallyControlledUpdates;
+
+/** queue a change, makes sure it gets flushed at the end of frame */
+static void QueueLocallyControlledUpdate(uint32 ActorID, bool bLocallyControlled, bool bRemove)
+{
+	static FDelegateHandle EndFrameHandle;
+	if (!EndFrameHandle.IsValid())
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&USoundNodeLocalPlayer::FlushLocallyControlledUpdates);
+	}
+
+	PendingLocallyControlledUpdates.Add({ ActorID, bLocallyControlled, bRemove });
+}
+
 USoundNodeLocalPlayer::USoundNodeLocalPlayer(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
@@ -28,6 +55,56 @@ void USoundNodeLocalPlayer::ParseNodes(FAudioDevice* AudioDevice, const UPTRINT
 	}
 }
 
+void USoundNodeLocalPlayer::SetLocallyControlled(uint32 ActorID, bool bLocallyControlled)
+{
+	check(IsInGameThread());
+
+	bool* CachedValue = GameThreadLocallyControlledActors.Find(ActorID);
+	if (CachedValue && *CachedValue == bLocallyControlled)
+	{
+		return;
+	}
+
+	GameThreadLocallyControlledActors.Add(ActorID, bLocallyControlled);
+	QueueLocallyControlledUpdate(ActorID, bLocallyControlled, false);
+}
+
+void USoundNodeLocalPlayer::RemoveLocallyControlled(uint32 ActorID)
+{
+	check(IsInGameThread());
+
+	if (GameThreadLocallyControlledActors.Remove(ActorID) > 0)
+	{
+		QueueLocallyControlledUpdate(ActorID, false, true);
+	}
+}
+
+void USoundNodeLocalPlayer::FlushLocallyControlledUpdates()
+{
+	if (PendingLocallyControlledUpdates.Num() == 0)
+	{
+		return;
+	}
+
+	FAudioThread::RunCommandOnAudioThread([Updates = MoveTemp(PendingLocallyControlledUpdates)]()
+	{
+		TMap<uint32, bool>& Cache = GetLocallyControlledActorCache();
+		for (const FLocallyControlledUpdate& Update : Updates)
+		{
+			if (Update.bRemove)
+			{
+				Cache.Remove(Update.ActorID);
+			}
+			else
+			{
+				Cache.Add(Update.ActorID, Update.bLocallyControlled);
+			}
+		}
+	});
+
+	PendingLocallyControlledUpdates.Reset();
+}
+
 #if WITH_EDITOR
 FText USoundNodeLocalPlayer::GetInputPinName(int32 PinIndex) const
 {
@@ -3,6 +3,7 @@
 #include "ShooterGame.h"
 #include "ShooterTypes.h"
 #include "ShooterCharacter.h"
+#include "Weapons/ShooterDamageType.h"
 
 FTakeHitInfo::FTakeHitInfo()
 	: ActualDamage(0)
@@ -62,4 +63,132 @@ void FTakeHitInfo::SetDamageEvent(const FDamageEvent& DamageEvent)
 void FTakeHitInfo::EnsureReplication()
 {
 	EnsureReplicationByte++;
-}
\ No newline at end of file
+}
+
+/** bits for the damage type, last value means the class follows as an object reference */
+#define TAKEHIT_DAMAGETYPE_BITS		4
+#define TAKEHIT_DAMAGETYPE_OBJECT	((1 << TAKEHIT_DAMAGETYPE_BITS) - 1)
+
+bool FTakeHitInfo::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	// damage in quarter points, a couple of bytes for any real hit
+	uint32 PackedDamage = Ar.IsSaving() ? (uint32)FMath::Max(0, FMath::RoundToInt(ActualDamage * 4.0f)) : 0;
+	Ar.SerializeIntPacked(PackedDamage);
+
+	uint8 bPackedKilled = bKilled;
+	Ar.SerializeBits(&bPackedKilled, 1);
+
+	// needs to arrive so repeated identical hits still trigger the rep notify
+	Ar << EnsureReplicationByte;
+
+	// unmapped references (instigator not relevant, projectile already gone) are normal, they just arrive as null
+	UObject* Instigator = PawnInstigator.Get();
+	Map->SerializeObject(Ar, AShooterCharacter::StaticClass(), Instigator);
+	UObject* Causer = DamageCauser.Get();
+	Map->SerializeObject(Ar, AActor::StaticClass(), Causer);
+
+	// damage type as an index into UShooterDamageType::NetDamageTypes
+	uint8 DamageTypeIndex = 0;
+	if (Ar.IsSaving() && DamageTypeClass && DamageTypeClass != UDamageType::StaticClass())
+	{
+		const int32 NetIndex = UShooterDamageType::GetNetDamageTypeIndex(DamageTypeClass);
+		DamageTypeIndex = (NetIndex != INDEX_NONE && NetIndex + 1 < TAKEHIT_DAMAGETYPE_OBJECT) ? NetIndex + 1 : TAKEHIT_DAMAGETYPE_OBJECT;
+	}
+	Ar.SerializeBits(&DamageTypeIndex, TAKEHIT_DAMAGETYPE_BITS);
+
+	UObject* DamageTypeObject = DamageTypeClass;
+	if (DamageTypeIndex == TAKEHIT_DAMAGETYPE_OBJECT)
+	{
+		Map->SerializeObject(Ar, UClass::StaticClass(), DamageTypeObject);
+	}
+
+	// only the active event
+	uint8 EventType = 0;
+	if (Ar.IsSaving())
+	{
+		EventType = (DamageEventClassID == FPointDamageEvent::ClassID) ? 1 : (DamageEventClassID == FRadialDamageEvent::ClassID) ? 2 : 0;
+	}
+	Ar.SerializeBits(&EventType, 2);
+
+	FVector Direction = PointDamageEvent.ShotDirection;
+	FVector ImpactPoint = PointDamageEvent.HitInfo.ImpactPoint;
+	FVector Origin = RadialDamageEvent.Origin;
+
+	if (EventType == 1)
+	{
+		bOutSuccess &= SerializeFixedVector<1, 16>(Direction, Ar);
+		bOutSuccess &= SerializePackedVector<1, 20>(ImpactPoint, Ar);
+	}
+	else if (EventType == 2)
+	{
+		// clients only need the first component hit for the impulse direction
+		if (Ar.IsSaving())
+		{
+			ImpactPoint = RadialDamageEvent.ComponentHits.Num() > 0 ? RadialDamageEvent.ComponentHits[0].ImpactPoint : RadialDamageEvent.Origin;
+		}
+		bOutSuccess &= SerializePackedVector<1, 20>(Origin, Ar);
+		bOutSuccess &= SerializePackedVector<1, 20>(ImpactPoint, Ar);
+	}
+
+	if (Ar.IsLoading())
+	{
+		ActualDamage = PackedDamage / 4.0f;
+		bKilled = bPackedKilled;
+		PawnInstigator = Cast<AShooterCharacter>(Instigator);
+		DamageCauser = Cast<AActor>(Causer);
+
+		if (DamageTypeIndex == 0)
+		{
+			DamageTypeClass = UDamageType::StaticClass();
+		}
+		else if (DamageTypeIndex == TAKEHIT_DAMAGETYPE_OBJECT)
+		{
+			DamageTypeClass = Cast<UClass>(DamageTypeObject);
+		}
+		else
+		{
+			DamageTypeClass = UShooterDamageType::GetNetDamageType(DamageTypeIndex - 1);
+		}
+
+		switch (EventType)
+		{
+		case 1:
+		{
+			FPointDamageEvent PointEvent;
+			PointEvent.Damage = ActualDamage;
+			PointEvent.ShotDirection = Direction;
+			PointEvent.HitInfo.Location = ImpactPoint;
+			PointEvent.HitInfo.ImpactPoint = ImpactPoint;
+			PointEvent.HitInfo.ImpactNormal = -Direction;
+			PointEvent.HitInfo.bBlockingHit = true;
+			PointEvent.DamageTypeClass = DamageTypeClass;
+			SetDamageEvent(PointEvent);
+			break;
+		}
+		case 2:
+		{
+			FRadialDamageEvent RadialEvent;
+			RadialEvent.Origin = Origin;
+			FHitResult& Hit = RadialEvent.ComponentHits.AddDefaulted_GetRef();
+			Hit.Location = ImpactPoint;
+			Hit.ImpactPoint = ImpactPoint;
+			Hit.bBlockingHit = true;
+			RadialEvent.DamageTypeClass = DamageTypeClass;
+			SetDamageEvent(RadialEvent);
+			break;
+		}
+		default:
+		{
+			FDamageEvent GeneralEvent;
+			GeneralEvent.DamageTypeClass = DamageTypeClass;
+			SetDamageEvent(GeneralEvent);
+			break;
+		}
+		}
+	}
+
+	bOutSuccess &= !Ar.IsError();
+	return true;
+}
@@ -0,0 +1,312 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "Tests/ShooterTestControllerBotSoak.h"
+#include "ShooterGame.h"
+#include "Bots/ShooterAIController.h"
+#include "Bots/ShooterAILODManager.h"
+#include "Bots/ShooterLOSService.h"
+#include "Bots/ShooterPathCache.h"
+#include "Bots/ShooterPawnRegistry.h"
+#include "HAL/FileManager.h"
+
+void UShooterTestControllerBotSoak::OnInit()
+{
+	Super::OnInit();
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	if (!FParse::Value(CommandLine, TEXT("SoakMap="), SoakMap))
+	{
+		SoakMap = TEXT("Highrise");
+	}
+
+	if (!FParse::Value(CommandLine, TEXT("SoakGame="), SoakGame))
+	{
+		SoakGame = TEXT("TDM");
+	}
+
+	SoakBots = 100;
+	FParse::Value(CommandLine, TEXT("SoakBots="), SoakBots);
+
+	SoakWarmup = 30.0f;
+	FParse::Value(CommandLine, TEXT("SoakWarmup="), SoakWarmup);
+
+	SoakDuration = 600.0f;
+	FParse::Value(CommandLine, TEXT("SoakDuration="), SoakDuration);
+
+	if (!FParse::Value(CommandLine, TEXT("SoakCSV="), CsvPath))
+	{
+		CsvPath = FPaths::ProjectSavedDir() / TEXT("Soak") / FString::Printf(TEXT("BotSoak_%s_%d_%s.csv"), *SoakMap, SoakBots, *FDateTime::Now().ToString());
+	}
+
+	MaxFrameP95Ms = 0.f;
+	MaxFrameP99Ms = 0.f;
+	MaxAIMs = 0.f;
+	MaxMemoryGrowthMB = 0.f;
+	MaxActors = 0;
+	FParse::Value(CommandLine, TEXT("SoakMaxFrameP95Ms="), MaxFrameP95Ms);
+	FParse::Value(CommandLine, TEXT("SoakMaxFrameP99Ms="), MaxFrameP99Ms);
+	FParse::Value(CommandLine, TEXT("SoakMaxAIMs="), MaxAIMs);
+	FParse::Value(CommandLine, TEXT("SoakMaxMemoryGrowthMB="), MaxMemoryGrowthMB);
+	FParse::Value(CommandLine, TEXT("SoakMaxActors="), MaxActors);
+
+	bTravelRequested = false;
+	bSampling = false;
+	bFinished = false;
+	PlayStartTime = 0.0;
+	LastRowTime = 0.0;
+	LastNumTraces = 0;
+	RowAIMs = 0.f;
+	TotalAIMs = 0.f;
+	NumFrames = 0;
+	StartMemoryMB = 0.f;
+	PeakMemoryMB = 0.f;
+	LastMemoryMB = 0.f;
+	PeakActors = 0;
+	CsvFile = nullptr;
+
+	UE_LOG(LogGauntlet, Display, TEXT("Bot soak: %d bots on %s (%s), %.0f secs warmup, %.0f secs sampled, CSV %s"),
+		SoakBots, *SoakMap, *SoakGame, SoakWarmup, SoakDuration, *CsvPath);
+}
+
+void UShooterTestControllerBotSoak::OnPostMapChange(UWorld* World)
+{
+	// matches restart while soaking, keep going
+	UE_LOG(LogGauntlet, Display, TEXT("Bot soak: map changed to %s"), World ? *World->GetMapName() : TEXT("None"));
+}
+
+void UShooterTestControllerBotSoak::OnTick(float TimeDelta)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	if (!IsRunningDedicatedServer())
+	{
+		FailSoak(TEXT("has to run on a dedicated server"));
+		return;
+	}
+
+	if (!bSampling && GetTimeInCurrentState() > SoakWarmup + 300)
+	{
+		FailSoak(TEXT("match with bots didn't start in time"));
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	AShooterGameMode* GameMode = World ? World->GetAuthGameMode<AShooterGameMode>() : nullptr;
+	if (GameMode == nullptr)
+	{
+		return;
+	}
+
+	if (!bTravelRequested)
+	{
+		bTravelRequested = true;
+
+		const FString BotsOption = AShooterGameMode::GetBotsCountOptionName() + TEXT("=");
+		const TCHAR* CurrentBots = World->URL.GetOption(*BotsOption, nullptr);
+		if (CurrentBots == nullptr || FCString::Atoi(CurrentBots) != SoakBots || UWorld::RemovePIEPrefix(World->GetMapName()) != SoakMap)
+		{
+			World->ServerTravel(FString::Printf(TEXT("/Game/Maps/%s?game=%s?%s%d"), *SoakMap, *SoakGame, *BotsOption, SoakBots), true);
+			return;
+		}
+	}
+
+	// no human will log in, don't wait for warmup
+	if (!GameMode->IsMatchInProgress())
+	{
+		if (GameMode->GetMatchState() == MatchState::WaitingToStart)
+		{
+			GameMode->StartMatch();
+		}
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (PlayStartTime == 0.0)
+	{
+		PlayStartTime = Now;
+	}
+
+	if (Now - PlayStartTime < SoakWarmup)
+	{
+		return;
+	}
+
+	if (!bSampling)
+	{
+		bSampling = true;
+		LastRowTime = Now;
+		StartMemoryMB = PeakMemoryMB = LastMemoryMB = GetUsedMemoryMB();
+
+		const UShooterLOSService* LOSService = World->GetSubsystem<UShooterLOSService>();
+		LastNumTraces = LOSService ? LOSService->GetNumTraces() : 0;
+
+		CsvFile = IFileManager::Get().CreateFileWriter(*CsvPath);
+		if (CsvFile == nullptr)
+		{
+			FailSoak(FString::Printf(TEXT("couldn't create %s"), *CsvPath));
+			return;
+		}
+
+		WriteLine(TEXT("Time,Bots,AliveBots,FrameWorkMsP50,FrameWorkMsP95,FrameWorkMsP99,FrameWorkMsMax,GameThreadMsAvg,AIMsAvg,LOSTracesPerSec,PathfindingMsPerSec,MemoryMB,Actors"));
+		return;
+	}
+
+	// last frame without the time spent sleeping to hold the server tick rate, which would pad every sample to the tick interval
+	const float FrameMs = FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0) * 1000.0;
+	const UShooterAILODManager* AILODManager = World->GetSubsystem<UShooterAILODManager>();
+	const float AIMs = AILODManager ? AILODManager->GetAIUpdateMs() : 0.f;
+
+	RowFrameMs.Add(FrameMs);
+	RowGameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	RowAIMs += AIMs;
+
+	AllFrameMs.Add(FrameMs);
+	TotalAIMs += AIMs;
+	NumFrames++;
+
+	if (Now - LastRowTime >= 1.0)
+	{
+		WriteRow(Now);
+	}
+
+	if (Now - PlayStartTime >= SoakWarmup + SoakDuration)
+	{
+		FinishSoak();
+	}
+}
+
+void UShooterTestControllerBotSoak::WriteRow(double Now)
+{
+	UWorld* World = GetWorld();
+	const float RowSeconds = FMath::Max(static_cast<float>(Now - LastRowTime), KINDA_SMALL_NUMBER);
+	const int32 NumRowFrames = FMath::Max(RowFrameMs.Num(), 1);
+
+	int32 NumBots = 0;
+	for (FConstControllerIterator It = World->GetControllerIterator(); It; ++It)
+	{
+		NumBots += Cast<AShooterAIController>(It->Get()) ? 1 : 0;
+	}
+
+	UShooterPawnRegistry* PawnRegistry = World->GetSubsystem<UShooterPawnRegistry>();
+	const int32 NumAliveBots = PawnRegistry ? PawnRegistry->GetPawns().FilterByPredicate([](const FShooterPawnEntry& Entry) { return !Entry.Pawn->IsPlayerControlled(); }).Num() : 0;
+
+	// counter starts over when the match restarts in a new world
+	const UShooterLOSService* LOSService = World->GetSubsystem<UShooterLOSService>();
+	const uint32 NumTraces = LOSService ? LOSService->GetNumTraces() : 0;
+	const uint32 RowTraces = NumTraces >= LastNumTraces ? NumTraces - LastNumTraces : NumTraces;
+	LastNumTraces = NumTraces;
+
+	const UShooterPathCache* PathCache = World->GetSubsystem<UShooterPathCache>();
+
+	float GameThreadMs = 0.f;
+	for (float Ms : RowGameThreadMs)
+	{
+		GameThreadMs += Ms;
+	}
+
+	LastMemoryMB = GetUsedMemoryMB();
+	PeakMemoryMB = FMath::Max(PeakMemoryMB, LastMemoryMB);
+
+	const int32 NumActors = World->GetActorCount();
+	PeakActors = FMath::Max(PeakActors, NumActors);
+
+	WriteLine(FString::Printf(TEXT("%.1f,%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.1f,%.3f,%.1f,%d"),
+		Now - PlayStartTime - SoakWarmup, NumBots, NumAliveBots,
+		GetPercentile(RowFrameMs, 0.5f), GetPercentile(RowFrameMs, 0.95f), GetPercentile(RowFrameMs, 0.99f), GetPercentile(RowFrameMs, 1.0f),
+		GameThreadMs / NumRowFrames, RowAIMs / NumRowFrames, RowTraces / RowSeconds,
+		PathCache ? PathCache->GetPathfindingMsPerSecond() : 0.f, LastMemoryMB, NumActors));
+
+	RowFrameMs.Reset();
+	RowGameThreadMs.Reset();
+	RowAIMs = 0.f;
+	LastRowTime = Now;
+}
+
+void UShooterTestControllerBotSoak::FinishSoak()
+{
+	const float FrameP50 = GetPercentile(AllFrameMs, 0.5f);
+	const float FrameP95 = GetPercentile(AllFrameMs, 0.95f);
+	const float FrameP99 = GetPercentile(AllFrameMs, 0.99f);
+	const float AIMsAvg = TotalAIMs / FMath::Max(NumFrames, 1);
+	const float MemoryGrowthMB = LastMemoryMB - StartMemoryMB;
+
+	WriteLine(FString::Printf(TEXT("Total,%d,,%.2f,%.2f,%.2f,%.2f,,%.3f,,,%.1f,%d"),
+		SoakBots, FrameP50, FrameP95, FrameP99, GetPercentile(AllFrameMs, 1.0f), AIMsAvg, PeakMemoryMB, PeakActors));
+
+	delete CsvFile;
+	CsvFile = nullptr;
+
+	UE_LOG(LogGauntlet, Display, TEXT("Bot soak: %d frames, frame work ms p50 %.2f p95 %.2f p99 %.2f, AI ms %.3f, memory growth %.1f MB, peak actors %d"),
+		NumFrames, FrameP50, FrameP95, FrameP99, AIMsAvg, MemoryGrowthMB, PeakActors);
+
+	TArray<FString> Regressions;
+	if (MaxFrameP95Ms > 0.f && FrameP95 > MaxFrameP95Ms)
+	{
+		Regressions.Add(FString::Printf(TEXT("frame work ms p95 %.2f > %.2f"), FrameP95, MaxFrameP95Ms));
+	}
+	if (MaxFrameP99Ms > 0.f && FrameP99 > MaxFrameP99Ms)
+	{
+		Regressions.Add(FString::Printf(TEXT("frame work ms p99 %.2f > %.2f"), FrameP99, MaxFrameP99Ms));
+	}
+	if (MaxAIMs > 0.f && AIMsAvg > MaxAIMs)
+	{
+		Regressions.Add(FString::Printf(TEXT("AI ms %.3f > %.3f"), AIMsAvg, MaxAIMs));
+	}
+	if (MaxMemoryGrowthMB > 0.f && MemoryGrowthMB > MaxMemoryGrowthMB)
+	{
+		Regressions.Add(FString::Printf(TEXT("memory growth %.1f MB > %.1f MB"), MemoryGrowthMB, MaxMemoryGrowthMB));
+	}
+	if (MaxActors > 0 && PeakActors > MaxActors)
+	{
+		Regressions.Add(FString::Printf(TEXT("peak actors %d > %d"), PeakActors, MaxActors));
+	}
+
+	if (Regressions.Num() > 0)
+	{
+		FailSoak(FString::Join(Regressions, TEXT(", ")));
+		return;
+	}
+
+	bFinished = true;
+	EndTest(0);
+}
+
+void UShooterTestControllerBotSoak::FailSoak(const FString& Reason)
+{
+	delete CsvFile;
+	CsvFile = nullptr;
+
+	UE_LOG(LogGauntlet, Error, TEXT("Bot soak failed: %s"), *Reason);
+	bFinished = true;
+	EndTest(-1);
+}
+
+void UShooterTestControllerBotSoak::WriteLine(const FString& Line)
+{
+	if (CsvFile)
+	{
+		FTCHARToUTF8 Utf8Line(*(Line + LINE_TERMINATOR));
+		CsvFile->Serialize(const_cast<ANSICHAR*>(Utf8Line.Get()), Utf8Line.Length());
+		CsvFile->Flush();
+	}
+}
+
+float UShooterTestControllerBotSoak::GetPercentile(TArray<float> Samples, float Percentile)
+{
+	if (Samples.Num() == 0)
+	{
+		return 0.f;
+	}
+
+	Samples.Sort();
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Samples.Num()) - 1, 0, Samples.Num() - 1);
+	return Samples[Index];
+}
+
+float UShooterTestControllerBotSoak::GetUsedMemoryMB()
+{
+	return FPlatformMemory::GetStats().UsedPhysical / (1024.f * 1024.f);
+}
@@ -0,0 +1,168 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "Tests/ShooterTestControllerFXAllocation.h"
+#include "ShooterGame.h"
+#include "Weapons/ShooterWeapon.h"
+
+void UShooterTestControllerFXAllocation::OnInit()
+{
+	Super::OnInit();
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	if (!FParse::Value(CommandLine, TEXT("FXMap="), FXMap))
+	{
+		FXMap = TEXT("Highrise");
+	}
+
+	FXWarmup = 10.0f;
+	FParse::Value(CommandLine, TEXT("FXWarmup="), FXWarmup);
+
+	FXDuration = 60.0f;
+	FParse::Value(CommandLine, TEXT("FXDuration="), FXDuration);
+
+	bFinished = false;
+	bSampling = false;
+	FireStartTime = 0.0;
+	BaselineAllocated = 0;
+}
+
+void UShooterTestControllerFXAllocation::OnUserCanPlayOnline(const FUniqueNetId& UserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResults)
+{
+	Super::OnUserCanPlayOnline(UserId, Privilege, PrivilegeResults);
+
+	if (PrivilegeResults == (uint32)IOnlineIdentity::EPrivilegeResults::NoFailures)
+	{
+		HostGame();
+	}
+}
+
+void UShooterTestControllerFXAllocation::HostGame()
+{
+	UShooterGameInstance* GameInstance = GetGameInstance();
+	ULocalPlayer* PlayerOwner          = GameInstance ? GameInstance->GetFirstGamePlayer() : nullptr;
+
+	if (PlayerOwner)
+	{
+		// bots would die and respawn with new weapons, which allocate new pools
+		const FString GameType = TEXT("FFA");
+		const FString StartURL = FString::Printf(TEXT("/Game/Maps/%s?game=%s?%s=0"), *FXMap, *GameType, *AShooterGameMode::GetBotsCountOptionName());
+
+		GameInstance->HostGame(PlayerOwner, GameType, StartURL);
+	}
+	else
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Failed!  Could not find LocalPlayer or GameInstance is null!"));
+		FinishTest(-1);
+	}
+}
+
+void UShooterTestControllerFXAllocation::OnTick(float TimeDelta)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	Super::OnTick(TimeDelta);
+
+	if (IsRunningDedicatedServer())
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("FX allocation test has to run on a client, dedicated servers don't spawn effects"));
+		FinishTest(-1);
+		return;
+	}
+
+	if (FireStartTime == 0.0 && GetTimeInCurrentState() > 300)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("FX allocation test: local player didn't start firing in time"));
+		FinishTest(-1);
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	AShooterGameMode* GameMode = World && IsInGame() ? World->GetAuthGameMode<AShooterGameMode>() : nullptr;
+	if (GameMode == nullptr)
+	{
+		return;
+	}
+
+	// nobody else will join, don't wait for warmup
+	if (!GameMode->IsMatchInProgress())
+	{
+		if (GameMode->GetMatchState() == MatchState::WaitingToStart)
+		{
+			GameMode->StartMatch();
+		}
+		return;
+	}
+
+	AShooterPlayerController* PC = Cast<AShooterPlayerController>(World->GetFirstPlayerController());
+	AShooterCharacter* Pawn = PC ? Cast<AShooterCharacter>(PC->GetPawn()) : nullptr;
+	if (Pawn == nullptr)
+	{
+		return;
+	}
+
+	if (FiringPawn.Get() != Pawn)
+	{
+		if (bSampling)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("FX allocation test: local player respawned while sampling"));
+			FinishTest(-1);
+			return;
+		}
+
+		PC->SetGodMode(true);
+		PC->SetInfiniteAmmo(true);
+		PC->SetInfiniteClip(true);
+		Pawn->StartWeaponFire();
+
+		FiringPawn = Pawn;
+		FireStartTime = FPlatformTime::Seconds();
+		return;
+	}
+
+	const double FiringTime = FPlatformTime::Seconds() - FireStartTime;
+	if (FiringTime < FXWarmup)
+	{
+		return;
+	}
+
+	if (!bSampling)
+	{
+		bSampling = true;
+		BaselineAllocated = AShooterWeapon::NumFXComponentsAllocated;
+
+		if (BaselineAllocated == 0)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("FX allocation test: no weapon effects were spawned during %.0f secs of firing"), FXWarmup);
+			FinishTest(-1);
+		}
+		return;
+	}
+
+	if (FiringTime >= FXWarmup + FXDuration)
+	{
+		Pawn->StopWeaponFire();
+
+		const int32 NumAllocated = AShooterWeapon::NumFXComponentsAllocated - BaselineAllocated;
+		if (NumAllocated > 0)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("FX allocation test: %d effect components allocated after warmup (%d before)"), NumAllocated, BaselineAllocated);
+			FinishTest(-1);
+			return;
+		}
+
+		UE_LOG(LogGauntlet, Display, TEXT("FX allocation test: %d effect components, none allocated in %.0f secs of firing after warmup"), BaselineAllocated, FXDuration);
+		FinishTest(0);
+	}
+}
+
+void UShooterTestControllerFXAllocation::FinishTest(int32 ExitCode)
+{
+	if (!bFinished)
+	{
+		bFinished = true;
+		EndTest(ExitCode);
+	}
+}
@@ -5,4 +5,41 @@
 
 UShooterDamageType::UShooterDamageType(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
-}
\ No newline at end of file
+}
+
+int32 UShooterDamageType::GetNetDamageTypeIndex(const UClass* DamageTypeClass)
+{
+	if (DamageTypeClass)
+	{
+		const int32 NumTypes = GetDefault<UShooterDamageType>()->NetDamageTypes.Num();
+		for (int32 i = 0; i < NumTypes; i++)
+		{
+			if (GetNetDamageType(i) == DamageTypeClass)
+			{
+				return i;
+			}
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+UClass* UShooterDamageType::GetNetDamageType(int32 Index)
+{
+	// resolved lazily, classes listed in config may not be loaded yet
+	static TArray<TWeakObjectPtr<UClass>> ResolvedTypes;
+
+	const TArray<FSoftClassPath>& Types = GetDefault<UShooterDamageType>()->NetDamageTypes;
+	if (!Types.IsValidIndex(Index))
+	{
+		return nullptr;
+	}
+
+	ResolvedTypes.SetNum(Types.Num());
+	if (!ResolvedTypes[Index].IsValid())
+	{
+		ResolvedTypes[Index] = Types[Index].ResolveClass();
+	}
+
+	return ResolvedTypes[Index].Get();
+}
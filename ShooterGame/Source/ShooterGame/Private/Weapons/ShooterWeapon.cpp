@@ -3,12 +3,33 @@
 #include "ShooterGame.h"
 #include "Weapons/ShooterWeapon.h"
 #include "Player/ShooterCharacter.h"
+#include "Player/ShooterHitboxComponent.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Bots/ShooterAIController.h"
 #include "Online/ShooterPlayerState.h"
 #include "UI/ShooterHUD.h"
+#include "Sound/ShooterAudioManager.h"
 #include "MatineeCameraShake.h"
 
+static int32 ServerHitboxTraces = 1;
+FAutoConsoleVariableRef CVarServerHitboxTraces(
+	TEXT("p.ServerHitboxTraces"),
+	ServerHitboxTraces,
+	TEXT("Resolve weapon traces against simplified pawn hitboxes on dedicated servers before tracing world geometry.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static int32 MaxRemoteMuzzleFXPerFrame = 8;
+FAutoConsoleVariableRef CVarMaxRemoteMuzzleFXPerFrame(
+	TEXT("p.MaxRemoteMuzzleFXPerFrame"),
+	MaxRemoteMuzzleFXPerFrame,
+	TEXT("Max muzzle flashes started per frame for weapons of other players. Local player is never limited. 0: unlimited"),
+	ECVF_Default);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon FX Components Allocated"), STAT_ShooterWeaponFXAllocated, STATGROUP_Game);
+
+int32 AShooterWeapon::NumFXComponentsAllocated = 0;
+
 AShooterWeapon::AShooterWeapon(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	Mesh1P = ObjectInitializer.CreateDefaultSubobject<USkeletalMeshComponent>(this, TEXT("WeaponMesh1P"));
@@ -33,6 +54,9 @@ AShooterWeapon::AShooterWeapon(const FObjectInitializer& ObjectInitializer) : Su
 	Mesh3P->SetupAttachment(Mesh1P);
 
 	bLoopedMuzzleFX = false;
+	MuzzleFXPoolSize = 2;
+	NextMuzzle1P = 0;
+	NextMuzzle3P = 0;
 	bLoopedFireAnim = false;
 	bPlayingFireAnim = false;
 	bIsEquipped = false;
@@ -756,12 +780,133 @@ FHitResult AShooterWeapon::WeaponTrace(const FVector& StartTrace, const FVector&
 	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(WeaponTrace), true, GetInstigator());
 	TraceParams.bReturnPhysicalMaterial = true;
 
+	// dedicated server resolves pawns against hitboxes, world trace only has to check what's in front of them
+	FHitResult PawnHit(ForceInit);
+	const bool bUseHitboxes = ServerHitboxTraces == 1 && GetNetMode() == NM_DedicatedServer;
+	const bool bHitPawn = bUseHitboxes && HitboxTrace(StartTrace, EndTrace, TraceParams, PawnHit);
+	const FVector WorldTraceEnd = bHitPawn ? PawnHit.Location : EndTrace;
+
 	FHitResult Hit(ForceInit);
-	GetWorld()->LineTraceSingleByChannel(Hit, StartTrace, EndTrace, COLLISION_WEAPON, TraceParams);
+	const bool bHitWorld = GetWorld()->LineTraceSingleByChannel(Hit, StartTrace, WorldTraceEnd, COLLISION_WEAPON, TraceParams);
+
+	if (bHitPawn && !bHitWorld)
+	{
+		return PawnHit;
+	}
+
+	if (bHitPawn)
+	{
+		// world trace was shortened, report time relative to the full trace
+		const float TraceLength = (EndTrace - StartTrace).Size();
+		Hit.Time = TraceLength > 0.f ? Hit.Distance / TraceLength : 0.f;
+		Hit.TraceEnd = EndTrace;
+	}
 
 	return Hit;
 }
 
+bool AShooterWeapon::HitboxTrace(const FVector& StartTrace, const FVector& EndTrace, FCollisionQueryParams& TraceParams, FHitResult& OutHit) const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ShooterWeapon_HitboxTrace);
+
+	const FVector TraceDelta = EndTrace - StartTrace;
+	const float TraceLength = TraceDelta.Size();
+	if (TraceLength <= KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const FVector TraceDir = TraceDelta / TraceLength;
+	float BestDistance = TraceLength;
+	bool bHit = false;
+
+	for (AShooterCharacter* TestPawn : TActorRange<AShooterCharacter>(GetWorld()))
+	{
+		UShooterHitboxComponent* Hitboxes = TestPawn->GetHitboxComponent();
+		if (TestPawn == GetInstigator() || !TestPawn->IsAlive() || Hitboxes == NULL || !Hitboxes->HasHitboxes())
+		{
+			// the world trace hits pawns without hitboxes
+			continue;
+		}
+
+		TraceParams.AddIgnoredActor(TestPawn);
+
+		FHitResult TestHit(ForceInit);
+		if (Hitboxes->RaycastHitboxes(StartTrace, TraceDir, BestDistance, TestHit))
+		{
+			BestDistance = TestHit.Distance;
+			OutHit = TestHit;
+			OutHit.TraceEnd = EndTrace;
+			OutHit.Time = BestDistance / TraceLength;
+			bHit = true;
+		}
+	}
+
+	return bHit;
+}
+
+UParticleSystemComponent* AShooterWeapon::GetPooledFX(TArray<UParticleSystemComponent*>& Pool, int32& NextIndex, int32 PoolSize, UParticleSystem* Template, USceneComponent* AttachParent, FName AttachPoint)
+{
+	if (Template == NULL || PoolSize <= 0)
+	{
+		return NULL;
+	}
+
+	if (Pool.Num() < PoolSize)
+	{
+		UParticleSystemComponent* NewPSC = NewObject<UParticleSystemComponent>(this);
+		NewPSC->bAutoActivate = false;
+		NewPSC->bAutoDestroy = false;
+		NewPSC->SetTemplate(Template);
+		if (AttachParent)
+		{
+			NewPSC->SetupAttachment(AttachParent, AttachPoint);
+		}
+		else
+		{
+			NewPSC->SetUsingAbsoluteLocation(true);
+			NewPSC->SetUsingAbsoluteRotation(true);
+			NewPSC->SetupAttachment(GetRootComponent());
+		}
+		NewPSC->RegisterComponent();
+
+		Pool.Add(NewPSC);
+		NumFXComponentsAllocated++;
+		INC_DWORD_STAT(STAT_ShooterWeaponFXAllocated);
+
+		return NewPSC;
+	}
+
+	// pool is full, restart the oldest one
+	NextIndex = NextIndex % Pool.Num();
+	UParticleSystemComponent* PooledPSC = Pool[NextIndex];
+	NextIndex = (NextIndex + 1) % Pool.Num();
+
+	if (PooledPSC->Template != Template)
+	{
+		PooledPSC->SetTemplate(Template);
+	}
+
+	return PooledPSC;
+}
+
+bool AShooterWeapon::ConsumeFXFrameBudget(uint64& BudgetFrame, int32& SpawnedThisFrame, int32 MaxPerFrame)
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		SpawnedThisFrame = 0;
+	}
+
+	if (MaxPerFrame > 0 && SpawnedThisFrame >= MaxPerFrame)
+	{
+		return false;
+	}
+
+	SpawnedThisFrame++;
+	return true;
+}
+
 void AShooterWeapon::SetOwningPawn(AShooterCharacter* NewOwner)
 {
 	if (MyPawn != NewOwner)
@@ -819,6 +964,11 @@ void AShooterWeapon::SimulateWeaponFire()
 		return;
 	}
 
+	if (MyPawn)
+	{
+		MyPawn->NotifyCombatActivity();
+	}
+
 	if (MuzzleFX)
 	{
 		USkeletalMeshComponent* UseWeaponMesh = GetWeaponMesh();
@@ -830,20 +980,38 @@ void AShooterWeapon::SimulateWeaponFire()
 				AController* PlayerCon = MyPawn->GetController();				
 				if( PlayerCon != NULL )
 				{
-					Mesh1P->GetSocketLocation(MuzzleAttachPoint);
-					MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, Mesh1P, MuzzleAttachPoint);
-					MuzzlePSC->bOwnerNoSee = false;
-					MuzzlePSC->bOnlyOwnerSee = true;
-
-					Mesh3P->GetSocketLocation(MuzzleAttachPoint);
-					MuzzlePSCSecondary = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, Mesh3P, MuzzleAttachPoint);
-					MuzzlePSCSecondary->bOwnerNoSee = true;
-					MuzzlePSCSecondary->bOnlyOwnerSee = false;				
+					MuzzlePSC = GetPooledFX(MuzzlePool1P, NextMuzzle1P, MuzzleFXPoolSize, MuzzleFX, Mesh1P, MuzzleAttachPoint);
+					if (MuzzlePSC)
+					{
+						MuzzlePSC->bOwnerNoSee = false;
+						MuzzlePSC->bOnlyOwnerSee = true;
+						MuzzlePSC->ActivateSystem(true);
+					}
+
+					MuzzlePSCSecondary = GetPooledFX(MuzzlePool3P, NextMuzzle3P, MuzzleFXPoolSize, MuzzleFX, Mesh3P, MuzzleAttachPoint);
+					if (MuzzlePSCSecondary)
+					{
+						MuzzlePSCSecondary->bOwnerNoSee = true;
+						MuzzlePSCSecondary->bOnlyOwnerSee = false;
+						MuzzlePSCSecondary->ActivateSystem(true);
+					}
 				}				
 			}
 			else
 			{
-				MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, UseWeaponMesh, MuzzleAttachPoint);
+				// under heavy fire from other players, skip flashes past the frame budget
+				static uint64 MuzzleBudgetFrame = 0;
+				static int32 MuzzleFXThisFrame = 0;
+				if (ConsumeFXFrameBudget(MuzzleBudgetFrame, MuzzleFXThisFrame, MaxRemoteMuzzleFXPerFrame))
+				{
+					TArray<UParticleSystemComponent*>& UsePool = (UseWeaponMesh == Mesh1P) ? MuzzlePool1P : MuzzlePool3P;
+					int32& UseNext = (UseWeaponMesh == Mesh1P) ? NextMuzzle1P : NextMuzzle3P;
+					MuzzlePSC = GetPooledFX(UsePool, UseNext, MuzzleFXPoolSize, MuzzleFX, UseWeaponMesh, MuzzleAttachPoint);
+					if (MuzzlePSC)
+					{
+						MuzzlePSC->ActivateSystem(true);
+					}
+				}
 			}
 		}
 	}
@@ -861,9 +1029,10 @@ void AShooterWeapon::SimulateWeaponFire()
 			FireAC = PlayWeaponSound(FireLoopSound);
 		}
 	}
-	else
+	else if (FireSound && MyPawn)
 	{
-		PlayWeaponSound(FireSound);
+		// one shot, goes through the gunfire budget instead of an attached audio component
+		UShooterAudioManager::PlaySoundAtLocation(this, FireSound, MyPawn->GetActorLocation(), EShooterSoundCategory::Weapon, MyPawn);
 	}
 
 	AShooterPlayerController* PC = (MyPawn != NULL) ? Cast<AShooterPlayerController>(MyPawn->Controller) : NULL;
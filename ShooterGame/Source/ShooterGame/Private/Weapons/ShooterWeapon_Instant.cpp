@@ -5,9 +5,18 @@
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterImpactEffect.h"
 
+static int32 MaxRemoteTrailFXPerFrame = 8;
+FAutoConsoleVariableRef CVarMaxRemoteTrailFXPerFrame(
+	TEXT("p.MaxRemoteTrailFXPerFrame"),
+	MaxRemoteTrailFXPerFrame,
+	TEXT("Max smoke trails started per frame for weapons of other players. Local player is never limited. 0: unlimited"),
+	ECVF_Default);
+
 AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	CurrentFiringSpread = 0.0f;
+	TrailFXPoolSize = 4;
+	NextTrail = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -294,12 +303,22 @@ void AShooterWeapon_Instant::SpawnTrailEffect(const FVector& EndPoint)
 {
 	if (TrailFX)
 	{
+		static uint64 TrailBudgetFrame = 0;
+		static int32 TrailFXThisFrame = 0;
+		const bool bLocalPlayer = MyPawn && MyPawn->IsLocallyControlled();
+		if (!bLocalPlayer && !ConsumeFXFrameBudget(TrailBudgetFrame, TrailFXThisFrame, MaxRemoteTrailFXPerFrame))
+		{
+			return;
+		}
+
 		const FVector Origin = GetMuzzleLocation();
 
-		UParticleSystemComponent* TrailPSC = UGameplayStatics::SpawnEmitterAtLocation(this, TrailFX, Origin);
+		UParticleSystemComponent* TrailPSC = GetPooledFX(TrailPool, NextTrail, TrailFXPoolSize, TrailFX, NULL, NAME_None);
 		if (TrailPSC)
 		{
+			TrailPSC->SetWorldLocationAndRotation(Origin, FRotator::ZeroRotator);
 			TrailPSC->SetVectorParameter(TrailTargetParam, EndPoint);
+			TrailPSC->ActivateSystem(true);
 		}
 	}
 }
@@ -2,6 +2,7 @@
 
 #pragma once
 #include "AIController.h"
+#include "ShooterTypes.h"
 #include "ShooterAIController.generated.h"
 
 class UBehaviorTreeComponent;
@@ -25,6 +26,9 @@ public:
 	virtual void GameHasEnded(class AActor* EndGameFocus = NULL, bool bIsWinner = false) override;
 	virtual void BeginInactiveState() override;
 
+	/** Forget the current match, controller and blackboard are kept for the next one */
+	virtual void Reset() override;
+
 protected:
 	virtual void OnPossess(class APawn* InPawn) override;
 	virtual void OnUnPossess() override;
@@ -52,9 +56,35 @@ public:
 		
 	bool HasWeaponLOSToEnemy(AActor* InEnemyActor, const bool bAnyEnemy) const;
 
+	/**
+	* Set LOD tier and whether the behavior tree may run until the next LOD update.
+	*
+	* @param NewTier	Tier of the bot.
+	* @param bGranted	Behavior tree may run.
+	*/
+	void SetAILOD(EShooterAILOD::Type NewTier, bool bGranted);
+
+	/** get LOD tier */
+	EShooterAILOD::Type GetAILODTier() const { return AILODTier; }
+
+	/** behavior tree may run */
+	bool IsAIUpdateGranted() const { return bAIUpdateGranted; }
+
+	/** behavior tree ran, updates cost estimate */
+	void OnAIUpdated(float CostMs);
+
+	/** get smoothed behavior tree update cost */
+	float GetAIUpdateCost() const { return AIUpdateCostMs; }
+
+	/** get world time of the last granted update */
+	float GetLastAIGrantTime() const { return LastAIGrantTime; }
+
 	// Begin AAIController interface
 	/** Update direction AI is looking based on FocalPoint */
 	virtual void UpdateControlRotation(float DeltaTime, bool bUpdatePawn = true) override;
+
+	/** Reuse paths from UShooterPathCache before running pathfinding */
+	virtual void FindPathForMoveRequest(const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath) const override;
 	// End AAIController interface
 
 protected:
@@ -67,6 +97,24 @@ protected:
 	/** Handle for efficient management of Respawn timer */
 	FTimerHandle TimerHandle_Respawn;
 
+	/** LOD tier, set by UShooterAILODManager */
+	TEnumAsByte<EShooterAILOD::Type> AILODTier;
+
+	/** behavior tree may run, set by UShooterAILODManager */
+	uint8 bAIUpdateGranted : 1;
+
+	/** world time of the last granted update */
+	float LastAIGrantTime;
+
+	/** smoothed behavior tree update cost */
+	float AIUpdateCostMs;
+
+	/** control rotation time skipped while throttled */
+	float SkippedRotationTime;
+
+	/** world time the next full enemy scan may run in team games, see UShooterTeamPerception */
+	float NextEnemyScanTime;
+
 public:
 	/** Returns BlackboardComp subobject **/
 	FORCEINLINE UBlackboardComponent* GetBlackboardComp() const { return BlackboardComp; }
@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterTypes.h"
+#include "ShooterAILODManager.generated.h"
+
+class AShooterAIController;
+
+/**
+ * [server] Time slices bot behavior trees within a per frame budget.
+ * Bots are sorted into tiers by combat state and distance to human players; each tier has an update interval,
+ * due bots are granted an update most overdue first until the estimated cost reaches the budget.
+ * Bots waiting longer than the max delay are always granted, so none of them freezes.
+ */
+UCLASS()
+class UShooterAILODManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** add measured behavior tree update time of a bot */
+	void AddAIUpdateTime(float Ms) { FrameAIUpdateMs += Ms; }
+
+	/** get measured behavior tree update time of all bots in the last frame */
+	float GetAIUpdateMs() const { return LastFrameAIUpdateMs; }
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** bot waiting for an update */
+	struct FAILODCandidate
+	{
+		AShooterAIController* Controller;
+		EShooterAILOD::Type Tier;
+		float Priority;
+		bool bStarving;
+	};
+
+	/** get tier of a bot */
+	EShooterAILOD::Type CalcTier(const AShooterAIController* Controller, const TArray<FVector, TInlineAllocator<8>>& HumanLocations) const;
+
+	/** some bots were throttled, restore them when the feature gets disabled */
+	bool bHasThrottledBots;
+
+	/** behavior tree update time of the current frame, trees tick before us */
+	float FrameAIUpdateMs;
+
+	/** behavior tree update time of the last frame */
+	float LastFrameAIUpdateMs;
+};
@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "ShooterBehaviorTreeComponent.generated.h"
+
+/** Behavior tree that only runs on frames granted to its bot by UShooterAILODManager, skipped time is handed to the next update. */
+UCLASS()
+class UShooterBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_UCLASS_BODY()
+
+	// Begin UActorComponent interface
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+	// End UActorComponent interface
+
+protected:
+
+	/** time of skipped ticks since the last update */
+	float SkippedDeltaTime;
+};
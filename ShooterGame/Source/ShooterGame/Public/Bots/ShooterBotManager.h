@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterBotManager.generated.h"
+
+class AShooterAIController;
+
+/**
+ * [server] Bot controller creation and bot pawn spawns, spread over frames within p.BotSpawnBudgetMs.
+ * Match start is measured from StartBots until the queue is empty, reporting its worst frame.
+ */
+UCLASS()
+class UShooterBotManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** queue creation of a bot controller, its pawn is queued too if the match is in progress */
+	void QueueBotCreation(int32 BotNum);
+
+	/** queue spawning the pawn of a bot */
+	void QueueBotStart(AShooterAIController* Controller);
+
+	/** start measuring match start, ends once the queue is empty */
+	void BeginMatchStart();
+
+	/** get number of queued requests */
+	int32 GetNumQueued() const { return Queue.Num() - QueueHead; }
+
+	/** get worst frame of the last measured match start in ms */
+	float GetLastMatchStartWorstFrameMs() const { return LastMatchStartWorstFrameMs; }
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** queued creation or pawn spawn */
+	struct FBotSpawnRequest
+	{
+		/** bot to spawn a pawn for, unset for creation requests */
+		TWeakObjectPtr<AShooterAIController> Controller;
+
+		/** number of the bot to create, INDEX_NONE for pawn spawns */
+		int32 BotNum;
+	};
+
+	/** process queue within budget */
+	void ProcessQueue();
+
+	/** finish match start measurement and report it */
+	void EndMatchStart();
+
+	/** requests in order, processed from QueueHead */
+	TArray<FBotSpawnRequest> Queue;
+
+	/** first unprocessed request */
+	int32 QueueHead;
+
+	/** match start is being measured */
+	bool bMeasuringMatchStart;
+
+	/** frame BeginMatchStart was called */
+	uint64 MatchStartFrame;
+
+	/** real time BeginMatchStart was called */
+	double MatchStartTime;
+
+	/** bot pawns spawned during match start */
+	int32 MatchStartNumBots;
+
+	/** time spent creating and spawning bots during match start */
+	float MatchStartWorkMs;
+
+	/** worst frame during match start */
+	float MatchStartWorstFrameMs;
+
+	/** worst frame of the last measured match start */
+	float LastMatchStartWorstFrameMs;
+};
@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "ShooterLOSService.generated.h"
+
+/** bot and target pair asked for, one trace per key and frame at most */
+struct FShooterLOSKey
+{
+	/** controller asking */
+	TWeakObjectPtr<AController> Querier;
+
+	/** target actor, null for location targets */
+	TWeakObjectPtr<AActor> Target;
+
+	/** quantized target location for location targets */
+	FIntVector TargetCell;
+
+	/** trace from the pawn's eyes instead of its origin */
+	bool bFromEyes;
+
+	/** hitting any enemy of the querier counts as LOS */
+	bool bAnyEnemy;
+
+	FShooterLOSKey()
+		: TargetCell(ForceInitToZero)
+		, bFromEyes(false)
+		, bAnyEnemy(false)
+	{}
+
+	bool operator==(const FShooterLOSKey& Other) const
+	{
+		return Querier == Other.Querier && Target == Other.Target && TargetCell == Other.TargetCell
+			&& bFromEyes == Other.bFromEyes && bAnyEnemy == Other.bAnyEnemy;
+	}
+
+	friend uint32 GetTypeHash(const FShooterLOSKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.Querier), GetTypeHash(Key.Target));
+		Hash = HashCombine(Hash, GetTypeHash(Key.TargetCell));
+		return HashCombine(Hash, (Key.bFromEyes ? 1u : 0u) | (Key.bAnyEnemy ? 2u : 0u));
+	}
+};
+
+/** last known result of a key */
+struct FShooterLOSEntry
+{
+	/** latest requested target location */
+	FVector TargetLocation;
+
+	/** world time of the last request */
+	float LastRequestTime;
+
+	/** world time the result was traced */
+	float ResultTime;
+
+	/** id of the trace in flight, 0 when idle */
+	uint32 PendingTraceId;
+
+	/** result is valid */
+	uint8 bHasResult : 1;
+
+	/** last result */
+	uint8 bHasLOS : 1;
+
+	/** requested since the last dispatch */
+	uint8 bRequested : 1;
+
+	FShooterLOSEntry()
+		: TargetLocation(ForceInitToZero)
+		, LastRequestTime(0.f)
+		, ResultTime(0.f)
+		, PendingTraceId(0)
+		, bHasResult(false)
+		, bHasLOS(false)
+		, bRequested(false)
+	{}
+};
+
+/**
+ * Line of sight for bots, traced asynchronously on the weapon channel.
+ * Requests are deduplicated per bot and target; pairs asked for during a frame are traced once at the end of it
+ * and the results are read back from the next frame on, together with their age.
+ */
+UCLASS()
+class UShooterLOSService : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Get the last known line of sight from a bot to a target and keep it refreshed.
+	* Without a result yet the pair is queued and false is returned.
+	*
+	* @param Querier			Controller of the bot.
+	* @param TargetActor		Actor to see, null to test a location.
+	* @param TargetLocation		Location to see.
+	* @param bFromEyes			Trace from the pawn's eye height instead of its origin.
+	* @param bAnyEnemy			Hitting any enemy of the querier counts as LOS.
+	* @param bOutHasLOS			Last known result.
+	* @param OutAge				Seconds since the result was traced.
+	* @returns true if a result was available
+	*/
+	static bool GetLOS(AController* Querier, AActor* TargetActor, const FVector& TargetLocation, bool bFromEyes, bool bAnyEnemy, bool& bOutHasLOS, float* OutAge = nullptr);
+
+	/** get number of traces done since the world started */
+	uint32 GetNumTraces() const { return NumTraces; }
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** start async traces for requested pairs with an outdated result, forget pairs nobody asks for */
+	void DispatchTraces();
+
+	/** get trace start and params of a key, false if the querier has no pawn */
+	bool GetTraceStart(const FShooterLOSKey& Key, FVector& OutStart, FCollisionQueryParams& OutParams) const;
+
+	/** decide LOS from the trace of a key */
+	bool EvaluateHit(const FShooterLOSKey& Key, const FVector& TraceStart, const FVector& TargetLocation, const FHitResult* Hit) const;
+
+	/** async trace finished */
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	/** known pairs */
+	TMap<FShooterLOSKey, FShooterLOSEntry> Entries;
+
+	/** trace id to the key it was started for */
+	TMap<uint32, FShooterLOSKey> PendingTraces;
+
+	/** async trace callback */
+	FTraceDelegate TraceDelegate;
+
+	/** last trace id handed out */
+	uint32 LastTraceId;
+
+	/** traces done since the world started */
+	uint32 NumTraces;
+};
@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "NavigationData.h"
+#include "ShooterPathCache.generated.h"
+
+/** path request endpoints snapped to navmesh polys and quantized */
+struct FShooterPathCacheKey
+{
+	const ANavigationData* NavData;
+	const FNavigationQueryFilter* QueryFilter;
+	NavNodeRef StartPoly;
+	NavNodeRef GoalPoly;
+	FIntVector StartCell;
+	FIntVector GoalCell;
+
+	/** projected endpoints, not part of the key */
+	FNavLocation Start;
+	FNavLocation Goal;
+
+	FShooterPathCacheKey()
+		: NavData(nullptr)
+		, QueryFilter(nullptr)
+		, StartPoly(INVALID_NAVNODEREF)
+		, GoalPoly(INVALID_NAVNODEREF)
+		, StartCell(ForceInitToZero)
+		, GoalCell(ForceInitToZero)
+	{}
+
+	bool IsValid() const { return NavData != nullptr && StartPoly != INVALID_NAVNODEREF && GoalPoly != INVALID_NAVNODEREF; }
+
+	bool operator==(const FShooterPathCacheKey& Other) const
+	{
+		return NavData == Other.NavData && QueryFilter == Other.QueryFilter && StartPoly == Other.StartPoly && GoalPoly == Other.GoalPoly
+			&& StartCell == Other.StartCell && GoalCell == Other.GoalCell;
+	}
+
+	friend uint32 GetTypeHash(const FShooterPathCacheKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.NavData), GetTypeHash(Key.QueryFilter));
+		Hash = HashCombine(Hash, HashCombine(GetTypeHash(Key.StartPoly), GetTypeHash(Key.GoalPoly)));
+		return HashCombine(Hash, HashCombine(GetTypeHash(Key.StartCell), GetTypeHash(Key.GoalCell)));
+	}
+};
+
+/** path found for a key */
+struct FShooterPathCacheEntry
+{
+	/** private copy, never handed to path following */
+	FNavPathSharedPtr Path;
+
+	/** projected endpoints the path was found for */
+	FVector StartLocation;
+	FVector GoalLocation;
+
+	/** world time the path was found */
+	float Time;
+};
+
+/**
+ * [server] Paths found for bot move requests, keyed by start and goal navmesh polys.
+ * A request with both endpoints in the same polys and cells as a cached path gets a copy of it with its own endpoints,
+ * and a request close to a path found in the same frame is merged into it, as long as navmesh raycasts
+ * from the new endpoints to the path stay clear. Paths touched by navmesh changes are dropped.
+ */
+UCLASS()
+class UShooterPathCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Find path for a query in the cache.
+	*
+	* @param Query		Pathfinding query of the move request.
+	* @param OutKey		Key of the query, pass it to AddPath after a miss.
+	* @param OutPath	Copy of the cached path.
+	* @returns true if a cached path was reused
+	*/
+	bool FindPath(const FPathFindingQuery& Query, FShooterPathCacheKey& OutKey, FNavPathSharedPtr& OutPath);
+
+	/**
+	* Store path found after a miss.
+	*
+	* @param Key		Key returned by FindPath.
+	* @param Query		Pathfinding query of the move request.
+	* @param Path		Path found for the query, a copy is cached.
+	*/
+	void AddPath(const FShooterPathCacheKey& Key, const FPathFindingQuery& Query, const FNavPathSharedPtr& Path);
+
+	/** add time spent on a move request path, reported per second */
+	void AddPathfindingTime(float Ms);
+
+	/** get pathfinding milliseconds per second of the last full window */
+	float GetPathfindingMsPerSecond() const { return PathfindingMsPerSecond; }
+
+protected:
+
+	/** build key of a query, invalid if an endpoint is off the navmesh */
+	FShooterPathCacheKey MakeKey(const FPathFindingQuery& Query) const;
+
+	/** new endpoints of the key can be connected to the cached path */
+	bool CanReusePath(const FShooterPathCacheEntry& Entry, const FShooterPathCacheKey& Key, const FPathFindingQuery& Query) const;
+
+	/** copy path with the endpoints of the key, registered on the nav data for navmesh changes */
+	FNavPathSharedPtr CopyPath(const FNavPathSharedPtr& Source, const FShooterPathCacheKey& Key, const FPathFindingQuery& Query) const;
+
+	/** entry can still be used */
+	bool IsEntryValid(const FShooterPathCacheEntry& Entry, float TimeSeconds) const;
+
+	/** cached paths */
+	TMap<FShooterPathCacheKey, FShooterPathCacheEntry> Entries;
+
+	/** keys of paths found in FrameKeysFrame */
+	TArray<FShooterPathCacheKey> FrameKeys;
+
+	/** frame of FrameKeys */
+	uint64 FrameKeysFrame;
+
+	/** pathfinding time in the current window */
+	float WindowPathfindingMs;
+
+	/** real time the current window started */
+	double WindowStartTime;
+
+	/** pathfinding milliseconds per second of the last full window */
+	float PathfindingMsPerSecond;
+};
@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterPawnRegistry.generated.h"
+
+class AShooterCharacter;
+
+/** live pawn captured for this frame */
+struct FShooterPawnEntry
+{
+	/** pawn, validated again when queried */
+	AShooterCharacter* Pawn;
+
+	/** location when the registry was built */
+	FVector Location;
+
+	/** team of the pawn's player state, INDEX_NONE without one */
+	int32 TeamNum;
+};
+
+/**
+ * Live pawns of the world in a uniform 2D grid with team buckets, rebuilt at most once per frame on first use.
+ * Bots ask it for the nearest enemies instead of each controller iterating every pawn in the world.
+ */
+UCLASS()
+class UShooterPawnRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Find nearest live enemies, closest first. Only grid cells that can still hold a closer enemy are visited.
+	*
+	* @param Querier		Controller asking, enemies are decided by AShooterCharacter::IsEnemyFor.
+	* @param Origin			Search origin.
+	* @param Radius			Search radius, 0 for no limit.
+	* @param MaxResults		Max enemies returned, 0 for no limit.
+	* @param OutEnemies		Enemies found.
+	* @param ExcludePawn	Pawn to skip.
+	* @returns number of enemies found
+	*/
+	int32 FindNearestEnemies(AController* Querier, const FVector& Origin, float Radius, int32 MaxResults, TArray<AShooterCharacter*>& OutEnemies, const AShooterCharacter* ExcludePawn = nullptr);
+
+	/**
+	* Get live pawns of a team.
+	*
+	* @param TeamNum	Team to list.
+	* @param OutPawns	Pawns of the team.
+	*/
+	void GetTeamPawns(int32 TeamNum, TArray<AShooterCharacter*>& OutPawns);
+
+	/** get all live pawns of this frame */
+	const TArray<FShooterPawnEntry>& GetPawns();
+
+	// Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	// End USubsystem interface
+
+protected:
+
+	/** rebuild grid and team buckets if it wasn't done this frame */
+	void UpdateRegistry();
+
+	/** get grid cell of a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** live pawns */
+	TArray<FShooterPawnEntry> Entries;
+
+	/** grid cell to entry indices */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** team to entry indices */
+	TMap<int32, TArray<int32>> TeamEntries;
+
+	/** bounds of occupied cells */
+	FIntPoint MinCell;
+	FIntPoint MaxCell;
+
+	/** cell size the grid was built with */
+	float GridCellSize;
+
+	/** frame the registry was built */
+	uint64 LastUpdateFrame;
+};
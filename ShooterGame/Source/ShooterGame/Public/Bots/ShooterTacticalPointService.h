@@ -0,0 +1,163 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "Async/Future.h"
+#include "ShooterTacticalPointService.generated.h"
+
+class AShooterCharacter;
+
+/** candidate position around an enemy */
+struct FShooterTacticalPoint
+{
+	/** location on the navmesh */
+	FVector Location;
+
+	/** shared score, bots add their own travel and crowding terms */
+	float Score;
+
+	/** enemy visible from standing eye height */
+	uint8 bHasLOS : 1;
+
+	/** low obstacle between the point and the enemy */
+	uint8 bHasCover : 1;
+
+	FShooterTacticalPoint()
+		: Location(ForceInitToZero)
+		, Score(0.f)
+		, bHasLOS(false)
+		, bHasCover(false)
+	{}
+};
+
+/** position picked by a bot, other bots avoid it */
+struct FShooterTacticalClaim
+{
+	TWeakObjectPtr<AController> Controller;
+	FVector Location;
+	float Time;
+};
+
+/** candidate positions around one enemy, shared by every bot targeting it */
+struct FShooterTacticalQuery
+{
+	/** last scored points */
+	TArray<FShooterTacticalPoint> Points;
+
+	/** points waiting for their traces or being scored */
+	TArray<FShooterTacticalPoint> PendingPoints;
+
+	/** enemy location PendingPoints were generated around */
+	FVector PendingEnemyLocation;
+
+	/** enemy location Points were generated around */
+	FVector ScoredEnemyLocation;
+
+	/** positions picked by bots */
+	TArray<FShooterTacticalClaim> Claims;
+
+	/** world time Points were scored */
+	float ResultTime;
+
+	/** world time of the last request */
+	float LastRequestTime;
+
+	/** id of the last generation, 0 before the first one; stale trace results are ignored */
+	int32 Generation;
+
+	/** traces of PendingPoints still in flight */
+	int32 NumPendingTraces;
+
+	/** PendingPoints are being scored on a worker */
+	bool bScoring;
+
+	FShooterTacticalQuery()
+		: PendingEnemyLocation(ForceInitToZero)
+		, ScoredEnemyLocation(ForceInitToZero)
+		, ResultTime(0.f)
+		, LastRequestTime(0.f)
+		, Generation(0)
+		, NumPendingTraces(0)
+		, bScoring(false)
+	{}
+};
+
+/**
+ * [server] Tactical positions around enemies, shared by all bots targeting the same enemy.
+ * Candidates on rings around the enemy are projected on the navmesh, get async visibility and cover traces,
+ * and are scored by range, visibility, cover and height on a worker thread.
+ * Bots pick the best scored point adding their own travel distance and crowding penalties.
+ */
+UCLASS()
+class UShooterTacticalPointService : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Pick best scored position near an enemy and claim it.
+	* Without scored points yet the query is started and false is returned.
+	*
+	* @param Querier		Controller of the bot.
+	* @param Enemy			Enemy to fight.
+	* @param OutLocation	Picked position.
+	* @returns true if a position was picked
+	*/
+	bool FindPointNearEnemy(AController* Querier, AShooterCharacter* Enemy, FVector& OutLocation);
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** points of one query handed to the worker */
+	struct FScoreJob
+	{
+		TWeakObjectPtr<AShooterCharacter> Enemy;
+		int32 Generation;
+		FVector EnemyLocation;
+		TArray<FShooterTacticalPoint> Points;
+	};
+
+	/** trace in flight */
+	struct FPendingTrace
+	{
+		TWeakObjectPtr<AShooterCharacter> Enemy;
+		int32 Generation;
+		int32 PointIndex;
+		bool bCoverTrace;
+	};
+
+	/** project candidates around the enemy and start their traces */
+	void GeneratePoints(AShooterCharacter* Enemy, FShooterTacticalQuery& Query);
+
+	/** async trace finished */
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	/** queries per enemy */
+	TMap<TWeakObjectPtr<AShooterCharacter>, FShooterTacticalQuery> Queries;
+
+	/** trace id to the point it was started for */
+	TMap<uint32, FPendingTrace> PendingTraces;
+
+	/** scoring running on a worker */
+	TFuture<TArray<FScoreJob>> ScoringFuture;
+
+	/** async trace callback */
+	FTraceDelegate TraceDelegate;
+
+	/** last trace id handed out */
+	uint32 LastTraceId;
+
+	/** last query generation handed out */
+	int32 LastGeneration;
+};
@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterTeamPerception.generated.h"
+
+class AShooterCharacter;
+
+/** enemy last seen by a team */
+struct FShooterKnownEnemy
+{
+	/** enemy location when last seen */
+	FVector Location;
+
+	/** location of whoever saw it */
+	FVector SpotterLocation;
+
+	/** world time it was last seen */
+	float LastSeenTime;
+};
+
+/** known enemy as seen by one bot */
+struct FShooterPerceivedEnemy
+{
+	AShooterCharacter* Enemy;
+
+	/** 1 when just seen, fades to 0 over p.TeamPerceptionForgetTime */
+	float Confidence;
+
+	/** seconds since it was last seen */
+	float Age;
+
+	/** seen recently from close to the bot, it can pick the enemy without its own trace */
+	bool bTrusted;
+};
+
+/**
+ * [server] Enemies known to each team in team games, written by whichever bot or trace sees an enemy.
+ * Teammates pick enemies from it first and only run their own full scan every p.TeamPerceptionScanInterval,
+ * so line of sight work follows the number of visible enemies instead of bots times enemies.
+ */
+UCLASS()
+class UShooterTeamPerception : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** report enemy seen by a bot, ignored outside team games */
+	static void ReportSighting(AController* Spotter, AActor* Target);
+
+	/**
+	* Get enemies known to the team of a bot, closest first.
+	*
+	* @param Querier		Controller of the bot.
+	* @param OutEnemies		Known enemies.
+	* @returns false outside team games, the bot has to look for enemies on its own
+	*/
+	bool GetKnownEnemies(AController* Querier, TArray<FShooterPerceivedEnemy>& OutEnemies) const;
+
+	/** get seconds between full enemy scans of a bot in team games */
+	float GetScanInterval() const;
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** current game has teams */
+	bool IsTeamGame() const;
+
+	/** team to known enemies */
+	TMap<int32, TMap<TWeakObjectPtr<AShooterCharacter>, FShooterKnownEnemy>> TeamEnemies;
+};
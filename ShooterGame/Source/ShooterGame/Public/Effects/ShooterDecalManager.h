@@ -0,0 +1,123 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterTypes.h"
+#include "ShooterDecalManager.generated.h"
+
+class UDecalComponent;
+
+/** decal component owned by the manager */
+USTRUCT()
+struct FShooterDecalSlot
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** recycled decal component */
+	UPROPERTY()
+	UDecalComponent* Decal;
+
+	/** world time when the decal was placed */
+	float SpawnTime;
+
+	/** world time when the decal gets hidden */
+	float ExpireTime;
+
+	/** explosion decals are never replaced by bullet holes */
+	uint8 bExplosion : 1;
+
+	FShooterDecalSlot()
+		: Decal(nullptr)
+		, SpawnTime(0.f)
+		, ExpireTime(0.f)
+		, bExplosion(false)
+	{
+	}
+};
+
+/** decal waiting for the end of frame */
+struct FShooterDecalRequest
+{
+	/** material, size and lifespan */
+	FDecalData Decal;
+
+	/** decal box extent */
+	FVector DecalSize;
+
+	/** world placement */
+	FVector Location;
+	FRotator Rotation;
+
+	/** component the decal sticks to */
+	TWeakObjectPtr<USceneComponent> AttachComponent;
+	FName AttachBoneName;
+
+	/** explosion decals win over bullet holes */
+	bool bExplosion;
+
+	/** squared distance to the local view, closer decals win */
+	float DistanceSq;
+};
+
+/**
+ * World decal budget.
+ * Keeps a fixed size ring of decal components and reuses the oldest one instead of spawning new components,
+ * so the number of live decals doesn't depend on fire rate. Requests are collected during the frame and
+ * only the most important ones (explosions first, then closest to the local view) are placed.
+ */
+UCLASS()
+class UShooterDecalManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Queue decal for the end of the frame.
+	*
+	* @param WorldContextObject	Object in the world to place the decal in.
+	* @param Decal				Material, size and lifespan.
+	* @param DecalSize			Decal box extent.
+	* @param SurfaceHit			Surface to place the decal on.
+	* @param bExplosion			Explosion decals win over bullet holes.
+	*/
+	static void SpawnDecal(const UObject* WorldContextObject, const FDecalData& Decal, const FVector& DecalSize, const FHitResult& SurfaceHit, bool bExplosion);
+
+	// Begin USubsystem interface
+	virtual void Deinitialize() override;
+	// End USubsystem interface
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+	/** number of decal components created by the manager */
+	int32 GetNumDecalComponents() const { return Slots.Num(); }
+
+protected:
+
+	/** place queued decals within the per frame budget */
+	void FlushRequests();
+
+	/** hide decals past their lifespan and trim the ring when the budget shrinks */
+	void ExpireDecals();
+
+	/** pick slot for a new decal: free or expired first, then grow, then the oldest one the request may replace */
+	int32 FindSlot(bool bExplosion);
+
+	/** squared distance from the local view to a location */
+	float GetViewDistanceSq(const FVector& Location) const;
+
+	/** decal ring */
+	UPROPERTY()
+	TArray<FShooterDecalSlot> Slots;
+
+	/** requests from this frame */
+	TArray<FShooterDecalRequest> PendingRequests;
+};
@@ -7,8 +7,9 @@
 #include "ShooterGameMode.generated.h"
 
 class AShooterAIController;
-class AShooterPlayerState;
 class AShooterPickup;
+class AShooterCharacter;
+class AShooterPlayerState;
 class FUniqueNetId;
 
 UCLASS(config=Game)
@@ -46,6 +47,9 @@ class AShooterGameMode : public AGameMode
 	/** returns default pawn class for given controller */
 	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
 
+	/** reuses a pooled pawn of the right class if there is one, spawns a new pawn otherwise */
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
 	/** prevents friendly fire */
 	virtual float ModifyDamage(float Damage, AActor* DamagedActor, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) const;
 
@@ -73,6 +77,9 @@ class AShooterGameMode : public AGameMode
 	/** hides the onscreen hud and restarts the map */
 	virtual void RestartGame() override;
 
+	/** keeps bot controllers for the next match */
+	virtual void GetSeamlessTravelActorList(bool bToTransition, TArray<AActor*>& ActorList) override;
+
 	/** Creates AIControllers for all bots */
 	void CreateBotControllers();
 
@@ -109,6 +116,30 @@ protected:
 	UPROPERTY(config)
 	int32 MaxBots;
 
+	/** max number of dead pawns kept for reuse, 0 disables pawn recycling */
+	UPROPERTY(config)
+	int32 MaxPooledPawns;
+
+	/** dead pawns parked for reuse */
+	UPROPERTY()
+	TArray<AShooterCharacter*> PawnPool;
+
+	/** max number of expired dropped pickups kept for reuse, 0 disables pickup pooling */
+	UPROPERTY(config)
+	int32 MaxPooledPickups;
+
+	/** dropped pickups of each default inventory ammo drop class spawned into the pool when the match starts */
+	UPROPERTY(config)
+	int32 NumPrewarmedPickups;
+
+	/** reset bot controllers and keep them across seamless travel instead of creating new ones every match */
+	UPROPERTY(config)
+	bool bReuseBotControllers;
+
+	/** expired dropped pickups parked for reuse */
+	UPROPERTY()
+	TArray<AShooterPickup*> PickupPool;
+
 	UPROPERTY()
 	TArray<AShooterAIController*> BotControllers;
 
@@ -156,7 +187,30 @@ public:
 	/** get the name of the bots count option used in server travel URL */
 	static FString GetBotsCountOptionName();
 
-	UPROPERTY()
-	TArray<AShooterPickup*> LevelPickups;
+	/** can this pawn be parked in the pawn pool when it dies */
+	bool CanPoolPawn(const AShooterCharacter* Pawn) const;
+
+	/** park a dead pawn for reuse, returns false if the pool is full */
+	bool AddPawnToPool(AShooterCharacter* Pawn);
+
+	/** take a parked pawn of given class out of the pool, NULL if there is none */
+	AShooterCharacter* TakePawnFromPool(UClass* PawnClass);
+
+	/**
+	* Spawn a dropped pickup, reusing a parked one of the same class if possible.
+	*
+	* @param PickupClass	Class of the pickup.
+	* @param SpawnTransform	Where to drop it.
+	* @param DroppedWeapon	Weapon of the dying pawn, ammo pickups take their amount from it before they activate.
+	*/
+	AShooterPickup* SpawnDroppedPickup(TSubclassOf<AShooterPickup> PickupClass, const FTransform& SpawnTransform, class AShooterWeapon* DroppedWeapon = NULL);
+
+	/** park an expired dropped pickup for reuse, returns false if the pool is full */
+	bool AddPickupToPool(AShooterPickup* Pickup);
+
+protected:
+
+	/** fill the pickup pool with the ammo drops of the default inventories */
+	void PrewarmPickupPool();
 
 };
@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "ShooterPVSData.generated.h"
+
+/**
+ * Baked potentially visible set for a map.
+ * The map bounds are split into cubic cells and every pair of cells stores one bit telling whether anything
+ * in one cell could see into the other. Cleared bits are proven hidden, the server skips traces and
+ * replication for pawns in those cells. Baked in the editor with p.BakePVS, loaded from /Game/Maps/PVS/<Map>_PVS.
+ */
+UCLASS()
+class UShooterPVSData : public UDataAsset
+{
+	GENERATED_UCLASS_BODY()
+
+	/** get cell containing location, INDEX_NONE outside of the baked bounds */
+	int32 GetCellIndex(const FVector& Location) const;
+
+	/** can anything in one cell see into the other, cells outside of the baked bounds are always visible */
+	bool IsCellPairVisible(int32 CellA, int32 CellB) const;
+
+	/** can anything at one location possibly see the other */
+	bool IsPotentiallyVisible(const FVector& LocationA, const FVector& LocationB) const;
+
+	/** get asset package name for a map */
+	static FString GetPackageNameForWorld(const UWorld* World);
+
+#if WITH_EDITOR
+	/**
+	* Voxelize the world and trace visibility between all cells.
+	*
+	* @param World		World to bake, all loaded levels are included.
+	* @param InCellSize	Cell edge length.
+	* @returns false if the map doesn't fit into the cell limit
+	*/
+	bool Bake(UWorld* World, float InCellSize);
+#endif
+
+protected:
+
+	/** min corner of the baked bounds */
+	UPROPERTY(VisibleAnywhere, Category = PVS)
+	FVector Origin;
+
+	/** cell edge length */
+	UPROPERTY(VisibleAnywhere, Category = PVS)
+	float CellSize;
+
+	/** number of cells along each axis */
+	UPROPERTY(VisibleAnywhere, Category = PVS)
+	FIntVector Dimensions;
+
+	/** one bit per unordered cell pair, see GetPairBitIndex */
+	UPROPERTY()
+	TArray<uint32> VisibilityBits;
+
+	/** bit for a cell pair, the matrix is symmetric so only one triangle is stored */
+	static int32 GetPairBitIndex(int32 CellA, int32 CellB);
+
+	/** get total number of cells */
+	int32 GetNumCells() const { return Dimensions.X * Dimensions.Y * Dimensions.Z; }
+};
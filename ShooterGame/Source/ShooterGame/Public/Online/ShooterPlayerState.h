@@ -103,11 +103,11 @@ protected:
 	UPROPERTY(Transient, Replicated)
 	int32 NumDeaths;
 
-	/** number of bullets fired this match */
+	/** number of bullets fired this match, local stat that is never replicated */
 	UPROPERTY()
 	int32 NumBulletsFired;
 
-	/** number of rockets fired this match */
+	/** number of rockets fired this match, local stat that is never replicated */
 	UPROPERTY()
 	int32 NumRocketsFired;
 
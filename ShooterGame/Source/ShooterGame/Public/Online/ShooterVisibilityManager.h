@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "ShooterVisibilityManager.generated.h"
+
+class AShooterCharacter;
+class UShooterPVSData;
+
+/** cached visibility between a pawn and a viewer */
+struct FShooterVisibilityPair
+{
+	/** pawn whose check points are traced */
+	TWeakObjectPtr<AShooterCharacter> Pawn;
+
+	/** connection owner the view point is taken from */
+	TWeakObjectPtr<APlayerController> Viewer;
+
+	/** pawn location used for the last result */
+	FVector PawnLocation;
+
+	/** view location used for the last result */
+	FVector ViewLocation;
+
+	/** pending async traces, empty when no update is in flight */
+	TArray<FTraceHandle, TInlineAllocator<8>> PendingTraces;
+
+	/** world time of the last result */
+	float UpdateTime;
+
+	/** world time the pair was last queried */
+	float QueryTime;
+
+	/** at least one check point can be seen */
+	uint8 bVisible : 1;
+
+	/** result is valid */
+	uint8 bHasResult : 1;
+
+	FShooterVisibilityPair()
+		: PawnLocation(ForceInitToZero)
+		, ViewLocation(ForceInitToZero)
+		, UpdateTime(0.f)
+		, QueryTime(0.f)
+		, bVisible(true)
+		, bHasResult(false)
+	{
+	}
+};
+
+/**
+ * [server] Pawn to viewer visibility used to pause replication of hidden pawns.
+ * Pairs are registered when the net driver asks about them and refreshed with async traces at most once per frame.
+ * Results are reused while neither end moved much, and pawns viewing each other share one entry.
+ * Pairs the baked potentially visible set proves hidden are never traced.
+ */
+UCLASS()
+class UShooterVisibilityManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Read cached visibility, registers the pair for updates.
+	*
+	* @param Pawn		Pawn being replicated.
+	* @param Viewer		Owner of the connection.
+	* @returns false only if the pair was traced and no check point could be seen
+	*/
+	bool IsVisible(AShooterCharacter* Pawn, APlayerController* Viewer);
+
+	/** get baked visibility for the map, loaded on first use. NULL if not baked or disabled */
+	const UShooterPVSData* GetPVS();
+
+	// Begin USubsystem interface
+	virtual void Deinitialize() override;
+	// End USubsystem interface
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** get matrix key, pawns viewing each other map to the same key */
+	static uint64 GetPairKey(const AShooterCharacter* Pawn, const APlayerController* Viewer);
+
+	/** gather finished traces, returns true if the pair got a new result */
+	bool CollectTraces(FShooterVisibilityPair& Pair);
+
+	/** start async traces from the pawn check points to the view location */
+	int32 StartTraces(FShooterVisibilityPair& Pair, AShooterCharacter* Pawn, APlayerController* Viewer);
+
+	/** result is too old or an end moved too far */
+	bool NeedsUpdate(const FShooterVisibilityPair& Pair, const FVector& PawnLocation, const FVector& ViewLocation) const;
+
+	/** visibility matrix */
+	TMap<uint64, FShooterVisibilityPair> Pairs;
+
+	/** scratch check points */
+	TArray<FVector> CheckPoints;
+
+	/** baked visibility for the map */
+	UPROPERTY()
+	UShooterPVSData* PVSData;
+
+	/** PVSData load was attempted */
+	bool bPVSLoaded;
+};
@@ -16,9 +16,22 @@ class AShooterPickup : public AActor
 	/** check if pawn can use this pickup */
 	virtual bool CanBePickedUp(class AShooterCharacter* TestPawn) const;
 
+	/** is it ready for interactions? */
+	bool IsActive() const { return bIsActive; }
+
+	/** [server] take pickup out of the pickup pool and activate it at a new location */
+	void ReuseFromPool(const FTransform& SpawnTransform);
+
+	/** [server] park expired pickup in the pickup pool, destroys it when the pool is full */
+	void ReturnToPool();
+
+	/** check if pickup is parked in the pickup pool */
+	bool IsPooled() const { return bIsPooled; }
+
 protected:
 	/** initial setup */
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	void DestroyOnCooldown();
 
 private:
@@ -53,6 +66,9 @@ protected:
 
 	bool bCanRespawn;
 
+	/** [server] parked in the pickup pool, hidden and dormant until reused */
+	uint8 bIsPooled : 1;
+
 	/* The character who has picked up this pickup */
 	UPROPERTY(Transient, Replicated)
 	AShooterCharacter* PickedUpBy;
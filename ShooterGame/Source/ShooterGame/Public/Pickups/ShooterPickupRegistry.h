@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterPickupRegistry.generated.h"
+
+class AShooterPickup;
+
+/**
+ * [server] Pickups of the world, registered and unregistered by the pickups themselves.
+ * Active pickups are kept in a uniform 2D grid and counted per class, so a bot asking for the nearest usable pickup
+ * only visits cells that can still hold a closer one and skips classes without an active pickup.
+ */
+UCLASS()
+class UShooterPickupRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** register pickup or update its availability */
+	static void UpdatePickup(AShooterPickup* Pickup);
+
+	/** unregister pickup, it's being destroyed */
+	static void RemovePickup(AShooterPickup* Pickup);
+
+	/**
+	* Find nearest active pickup of a class.
+	*
+	* @param Origin			Search origin.
+	* @param PickupClass	Class of the pickup.
+	* @param Filter			Extra test a pickup has to pass.
+	* @param PathQuerier	If set, the pickup has to be reachable on the navmesh for this controller.
+	* @returns nearest pickup, null if there is none
+	*/
+	AShooterPickup* FindNearestPickup(const FVector& Origin, TSubclassOf<AShooterPickup> PickupClass, TFunctionRef<bool(AShooterPickup*)> Filter, AController* PathQuerier = nullptr) const;
+
+	/** get number of registered pickups */
+	int32 GetNumPickups() const { return Pickups.Num(); }
+
+protected:
+
+	/** get grid cell of a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** add active pickup to grid and class counts */
+	void AddActivePickup(AShooterPickup* Pickup);
+
+	/** remove active pickup from grid and class counts */
+	void RemoveActivePickup(AShooterPickup* Pickup);
+
+	/** hierarchical path test */
+	bool IsReachable(AController* PathQuerier, const FVector& Origin, const FVector& Destination) const;
+
+	/** registered pickups and whether they are in the grid */
+	TMap<AShooterPickup*, bool> Pickups;
+
+	/** grid cell to active pickups */
+	TMap<FIntPoint, TArray<AShooterPickup*>> ActiveCells;
+
+	/** active pickups per class */
+	TMap<UClass*, int32> NumActivePerClass;
+
+	/** bounds of occupied cells */
+	FIntPoint MinCell;
+	FIntPoint MaxCell;
+};
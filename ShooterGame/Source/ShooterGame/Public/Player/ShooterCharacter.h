@@ -22,7 +22,7 @@ class AShooterCharacter : public ACharacter
 	/** spawn inventory, setup initial variables */
 	virtual void PostInitializeComponents() override;
 
-	/** Update the character. (Running, health etc). */
+	/** Update cosmetic per frame state (run sounds, debug draw). Not registered on dedicated servers. */
 	virtual void Tick(float DeltaSeconds) override;
 
 	/** cleanup inventory */
@@ -34,6 +34,12 @@ class AShooterCharacter : public ACharacter
 	/** [server] perform PlayerState related setup */
 	virtual void PossessedBy(class AController* C) override;
 
+	/** [server] stop controller driven updates */
+	virtual void UnPossessed() override;
+
+	/** [client] controller changed, update local player sounds and regen */
+	virtual void OnRep_Controller() override;
+
 	/** [client] perform PlayerState related setup */
 	virtual void OnRep_PlayerState() override;
 
@@ -51,6 +57,9 @@ class AShooterCharacter : public ACharacter
 	*/
 	void OnCameraUpdate(const FVector& CameraLocation, const FRotator& CameraRotation);
 
+	/** handle mesh visibility and updates */
+	void UpdatePawnMeshes();
+
 	/** get aim offsets */
 	UFUNCTION(BlueprintCallable, Category = "Game|Weapon")
 		FRotator GetAimOffsets() const;
@@ -243,6 +252,9 @@ class AShooterCharacter : public ACharacter
 	*/
 	class AShooterWeapon* GetInventoryWeapon(int32 index) const;
 
+	/** get weapon classes given on spawn */
+	const TArray<TSubclassOf<class AShooterWeapon> >& GetDefaultInventoryClasses() const { return DefaultInventoryClasses; }
+
 	/** get weapon taget modifier speed	*/
 	UFUNCTION(BlueprintCallable, Category = "Game|Weapon")
 		float GetTargetingSpeedModifier() const;
@@ -270,6 +282,9 @@ class AShooterCharacter : public ACharacter
 	/** get max health */
 	int32 GetMaxHealth() const;
 
+	/** [server + local] set health, updates the low health sound and health regen */
+	void SetHealth(float NewHealth);
+
 	/** check if pawn is still alive */
 	bool IsAlive() const;
 
@@ -290,6 +305,10 @@ private:
 	/** pawn mesh: 1st person view */
 	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
 		USkeletalMeshComponent* Mesh1P;
+
+	/** simplified hitboxes for server side weapon traces */
+	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
+		class UShooterHitboxComponent* HitboxComponent;
 protected:
 
 	/** socket or bone name for attaching weapon mesh */
@@ -301,13 +320,17 @@ protected:
 		TArray<TSubclassOf<class AShooterWeapon> > DefaultInventoryClasses;
 
 	/** weapons in inventory */
-	UPROPERTY(Transient, Replicated)
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_Inventory)
 		TArray<class AShooterWeapon*> Inventory;
 
-	/** currently equipped weapon */
-	UPROPERTY(Transient, ReplicatedUsing = OnRep_CurrentWeapon)
+	/** currently equipped weapon, replicated as an inventory slot in PawnState */
+	UPROPERTY(Transient)
 		class AShooterWeapon* CurrentWeapon;
 
+	/** health, flags and equipped weapon slot, packed by the server before replication */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_PawnState)
+		struct FShooterPawnRepState PawnState;
+
 	/** Replicate where this pawn was last hit and damaged */
 	UPROPERTY(Transient, ReplicatedUsing = OnRep_LastTakeHitInfo)
 		struct FTakeHitInfo LastTakeHitInfo;
@@ -319,16 +342,16 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Inventory)
 		float TargetingSpeedModifier;
 
-	/** current targeting state */
-	UPROPERTY(Transient, Replicated)
+	/** current targeting state, replicated in PawnState */
+	UPROPERTY(Transient)
 		uint8 bIsTargeting : 1;
 
 	/** modifier for max movement speed */
 	UPROPERTY(EditDefaultsOnly, Category = Pawn)
 		float RunningSpeedModifier;
 
-	/** current running state */
-	UPROPERTY(Transient, Replicated)
+	/** current running state, replicated in PawnState */
+	UPROPERTY(Transient)
 		uint8 bWantsToRun : 1;
 
 	/** from gamepad running is toggled */
@@ -393,9 +416,6 @@ protected:
 	/** handles sounds for running */
 	void UpdateRunSounds();
 
-	/** handle mesh visibility and updates */
-	void UpdatePawnMeshes();
-
 	/** handle mesh colors on specified material instance */
 	void UpdateTeamColors(UMaterialInstanceDynamic* UseMID);
 
@@ -420,8 +440,8 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Health)
 		uint32 bIsDying : 1;
 
-	// Current health of the Pawn
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = Health)
+	// Current health of the Pawn, replicated quantized in PawnState
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Health)
 		float Health;
 
 	/** Take damage, handle death */
@@ -451,9 +471,113 @@ public:
 
 	/** Called on the actor right before replication occurs */
 	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Pawn pool
+
+	/** [server] should this pawn be parked in the game mode's pawn pool instead of torn off when it dies */
+	bool ShouldRecycleOnDeath() const;
+
+	/** [server] park the dead pawn hidden and without collision until the game mode reuses it */
+	void ReturnToPool();
+
+	/**
+	* [server] bring a parked pawn back to life at a spawn point.
+	*
+	* @param SpawnTransform	Where the pawn should respawn.
+	*/
+	void ReuseFromPool(const FTransform& SpawnTransform);
+
+	/** check if pawn is parked in the pawn pool */
+	bool IsPooled() const;
+
+protected:
+
+	/** pawn is parked in the pawn pool, replicated so clients can reset their copy */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_IsPooled)
+		uint8 bIsPooled : 1;
+
+	/** [server] pawn was not torn off on death and goes back to the pool after the ragdoll lifetime */
+	uint8 bPendingRecycle : 1;
+
+	/** Handle for parking the dead pawn in the pool */
+	FTimerHandle TimerHandle_ReturnToPool;
+
+	/** [client] reset or revive pooled pawn */
+	UFUNCTION()
+		void OnRep_IsPooled();
+
+	/** clear per-life state: ragdoll, collision, animation, abilities and input flags */
+	void ResetPooledState();
+
+	/** play respawn effects */
+	void PlayRespawnEffects();
+
+public:
+
+	//////////////////////////////////////////////////////////////////////////
+	// Significance
+
+	/** [client] set how much detail the local player needs for this pawn, stops looping sounds when minimal */
+	void SetSignificance(EShooterSignificance::Type NewSignificance);
+
+	/** get current significance */
+	EShooterSignificance::Type GetSignificance() const { return Significance; }
+
+	/** pawn fired or got hit, brings it back to full significance right away */
+	void NotifyCombatActivity();
+
+	/** get world time of the last shot fired or hit taken */
+	float GetLastCombatTime() const { return LastCombatTime; }
+
+protected:
+
+	/** current significance, set by UShooterSignificanceManager */
+	TEnumAsByte<EShooterSignificance::Type> Significance;
+
+	/** world time of the last shot fired or hit taken */
+	float LastCombatTime;
+
+public:
+
+	/** stop pose updates and physics of the corpse, used for settled or over budget ragdolls */
+	void FreezeMeshPose();
+
+protected:
+
+	/** hold the last frame of the death montage instead of simulating, returns false if it isn't playing */
+	bool HoldDeathPose();
+
+	/** Handle for freezing the death pose before the montage blends out */
+	FTimerHandle TimerHandle_FreezeMeshPose;
+
+public:
+
+	/** start or stop health regen, it runs only while the cheat is on and health is below max */
+	void UpdateHealthRegen();
+
+protected:
+
+	/** add health regen step */
+	void HealthRegenTimer();
+
+	/** start, stop or adjust the low health warning after health changed */
+	void UpdateLowHealthSound();
+
+	/** stop toggled running once the pawn stops or moves backwards */
+	void CheckRunToggle();
+
+	/** tell local player sound nodes whether this pawn is locally controlled */
+	void UpdateLocallyControlledSound();
+
+	/** Handle for health regen */
+	FTimerHandle TimerHandle_HealthRegen;
+
+	/** Handle for checking toggled running */
+	FTimerHandle TimerHandle_RunToggle;
+
 protected:
 
-	void SetHealth(float val) { Health = val; }
 	float GetHealth() { return Health; }
 
 	/** notification when killed, for both the server and client. */
@@ -478,9 +602,31 @@ protected:
 	/** updates current weapon */
 	void SetCurrentWeapon(class AShooterWeapon* NewWeapon, class AShooterWeapon* LastWeapon = NULL);
 
-	/** current weapon rep handler */
+	/** inventory rep handler, equips the replicated weapon slot once its weapon is mapped */
 	UFUNCTION()
-		void OnRep_CurrentWeapon(class AShooterWeapon* LastWeapon);
+		void OnRep_Inventory();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Packed state
+
+	/** [server] quantize health, flags and weapon slot into PawnState */
+	void UpdatePawnState();
+
+	/** pawn state rep handler, calls the field handlers below for changed fields */
+	UFUNCTION()
+		void OnRep_PawnState(const FShooterPawnRepState& PreviousState);
+
+	/** [client] replicated health changed */
+	void OnRep_Health();
+
+	/** [client] replicated targeting flag changed */
+	void OnRep_IsTargeting();
+
+	/** [client] replicated running flag changed */
+	void OnRep_WantsToRun();
+
+	/** [client] replicated weapon slot changed */
+	void OnRep_WeaponSlot();
 
 	/** [server] spawns default inventory */
 	void SpawnDefaultInventory();
@@ -506,6 +652,10 @@ protected:
 protected:
 	/** Returns Mesh1P subobject **/
 	FORCEINLINE USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
+
+public:
+	/** Returns HitboxComponent subobject **/
+	FORCEINLINE class UShooterHitboxComponent* GetHitboxComponent() const { return HitboxComponent; }
 };
 
 
@@ -95,6 +95,9 @@ public:
 	void StartTeleport();
 	void StartRewind();
 
+	/** clears rewind history, pending abilities and cooldowns; used when a pooled pawn is reused */
+	void ResetAbilityState();
+
 	float GetRewindCooldown() { return rewindCooldown; }
 	float GetTeleportCooldown() { return teleportCooldown; }
 
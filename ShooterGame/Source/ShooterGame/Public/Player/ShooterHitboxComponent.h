@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "ShooterHitboxComponent.generated.h"
+
+class USkeletalMeshComponent;
+class UPhysicalMaterial;
+class UPhysicsAsset;
+class UShooterHitboxPoseTable;
+
+/** single server hitbox: capsule attached to a bone of the 3rd person mesh */
+struct FShooterHitbox
+{
+	/** bone the capsule follows */
+	FName BoneName;
+
+	/** bone index in the mesh, INDEX_NONE if bone is missing */
+	int32 BoneIndex;
+
+	/** bone index in the baked pose table, INDEX_NONE if bone is missing */
+	int32 BakedBoneIndex;
+
+	/** capsule transform relative to the bone, capsule axis is local Z */
+	FTransform LocalTransform;
+
+	/** capsule radius */
+	float Radius;
+
+	/** half length of the capsule segment, without the caps */
+	float HalfLength;
+
+	/** physical material reported in hit results */
+	TWeakObjectPtr<UPhysicalMaterial> PhysMaterial;
+
+	/** world space segment start, updated from the current pose */
+	FVector SegmentStart;
+
+	/** world space segment end, updated from the current pose */
+	FVector SegmentEnd;
+
+	/** world space radius, updated from the current pose */
+	float WorldRadius;
+
+	FShooterHitbox()
+		: BoneIndex(INDEX_NONE)
+		, BakedBoneIndex(INDEX_NONE)
+		, Radius(0.f)
+		, HalfLength(0.f)
+		, SegmentStart(ForceInitToZero)
+		, SegmentEnd(ForceInitToZero)
+		, WorldRadius(0.f)
+	{
+	}
+};
+
+/**
+ * Simplified hit registration shape for a pawn.
+ * A handful of capsules built from the mesh physics asset, refreshed from the pose when queried.
+ * Instant hit weapons test these on the server instead of tracing the full physics setup.
+ */
+UCLASS(ClassGroup = Shooter, meta = (BlueprintSpawnableComponent))
+class UShooterHitboxComponent : public UActorComponent
+{
+	GENERATED_UCLASS_BODY()
+
+	/** enable pose recording and error measurement ticks when a pose table is set */
+	virtual void BeginPlay() override;
+
+	/** record baked poses or measure their error against the evaluated pose */
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** [server] hitboxes come from the baked pose table, 3rd person animation doesn't need to be evaluated */
+	bool ShouldSkipServerAnimation() const;
+
+	/**
+	* Find the closest hitbox hit along a ray.
+	*
+	* @param Origin		Ray start.
+	* @param Direction	Normalized ray direction.
+	* @param MaxDistance	Ray length.
+	* @param OutHit		Filled with hit data on success, Time is relative to MaxDistance.
+	* @returns true if any hitbox was hit
+	*/
+	bool RaycastHitboxes(const FVector& Origin, const FVector& Direction, float MaxDistance, FHitResult& OutHit);
+
+	/** refresh world space capsules from the current pose, once per frame */
+	void UpdateHitboxes();
+
+	/** rebuild capsules from the mesh physics asset */
+	void BuildHitboxes();
+
+	/** builds hitboxes if the physics asset changed, false if the mesh has none and hit registration has to use the mesh */
+	bool HasHitboxes();
+
+	/** get hitboxes, valid after UpdateHitboxes */
+	const TArray<FShooterHitbox>& GetHitboxes() const { return Hitboxes; }
+
+	/**
+	* Ray versus capsule intersection.
+	*
+	* @param Origin		Ray start.
+	* @param Direction	Normalized ray direction.
+	* @param SegmentStart	Capsule segment start.
+	* @param SegmentEnd	Capsule segment end.
+	* @param Radius		Capsule radius.
+	* @param OutDistance	Distance along the ray to the first intersection.
+	* @returns true if the ray enters the capsule in front of its origin
+	*/
+	static bool IntersectRayCapsule(const FVector& Origin, const FVector& Direction, const FVector& SegmentStart, const FVector& SegmentEnd, float Radius, float& OutDistance);
+
+protected:
+
+	/** upper limit for capsules taken from the physics asset, largest bodies are kept */
+	UPROPERTY(EditDefaultsOnly, Category = Hitbox)
+	int32 MaxHitboxes;
+
+	/** scale applied to physics asset radii, values above 1 make hit registration more forgiving */
+	UPROPERTY(EditDefaultsOnly, Category = Hitbox)
+	float RadiusScale;
+
+	/** baked poses used by dedicated servers instead of animation */
+	UPROPERTY(EditDefaultsOnly, Category = Hitbox)
+	UShooterHitboxPoseTable* BakedPoses;
+
+	/** resolve BakedBoneIndex of all hitboxes against the pose table */
+	void MapBakedBones();
+
+	/** compare baked pose with evaluated HitboxPose and accumulate error stats */
+	void MeasureBakedPoseError();
+
+	/** component space transforms of hitbox bones for the current frame */
+	TArray<FTransform> HitboxPose;
+
+	/** bone names of hitboxes, in hitbox order */
+	TArray<FName> HitboxBoneNames;
+
+	/** number of pose table bones when MapBakedBones ran */
+	int32 MappedBakedBonesNum;
+
+	/** skeletal mesh the hitboxes follow */
+	USkeletalMeshComponent* GetHitboxMesh() const;
+
+	/** hitboxes built from the physics asset */
+	TArray<FShooterHitbox> Hitboxes;
+
+	/** world space bounding sphere of all hitboxes, used to reject rays early */
+	FSphere Bounds;
+
+	/** frame of last UpdateHitboxes */
+	uint64 LastUpdateFrame;
+
+	/** hitboxes were built for this physics asset */
+	TWeakObjectPtr<UPhysicsAsset> BuiltForPhysicsAsset;
+};
@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "ShooterHitboxPoseTable.generated.h"
+
+class AShooterCharacter;
+
+namespace EHitboxMoveState
+{
+	enum Type
+	{
+		Idle,
+		Moving,
+		Running,
+		Falling,
+		MAX,
+	};
+}
+
+/** hitbox bone transforms for one pose table entry */
+USTRUCT()
+struct FShooterHitboxPose
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** component space transforms, one per table bone */
+	UPROPERTY(VisibleAnywhere, Category = Pose)
+	TArray<FTransform> BoneTransforms;
+
+	/** number of recorded samples averaged into this pose */
+	UPROPERTY(VisibleAnywhere, Category = Pose)
+	int32 NumSamples;
+
+	FShooterHitboxPose()
+		: NumSamples(0)
+	{
+	}
+};
+
+/**
+ * Baked hitbox poses, indexed by movement state, crouch and aim offsets.
+ * Lets the dedicated server place hitboxes without evaluating skeletal animation.
+ * Filled by playing with p.RecordHitboxPoses enabled in a game that evaluates animation (PIE, listen server).
+ */
+UCLASS()
+class UShooterHitboxPoseTable : public UDataAsset
+{
+	GENERATED_UCLASS_BODY()
+
+	/** number of aim pitch buckets between -90 and 90 degrees */
+	UPROPERTY(EditDefaultsOnly, Category = Pose)
+	int32 PitchBuckets;
+
+	/** number of aim yaw buckets between -MaxAimYaw and MaxAimYaw */
+	UPROPERTY(EditDefaultsOnly, Category = Pose)
+	int32 YawBuckets;
+
+	/** aim yaw range covered by the table */
+	UPROPERTY(EditDefaultsOnly, Category = Pose)
+	float MaxAimYaw;
+
+	/** bones stored in every pose */
+	UPROPERTY(VisibleAnywhere, Category = Pose)
+	TArray<FName> BoneNames;
+
+	/** pose entries, see GetPoseIndex for layout */
+	UPROPERTY(VisibleAnywhere, Category = Pose)
+	TArray<FShooterHitboxPose> Poses;
+
+	/**
+	* Find baked pose matching character state, falls back to the idle pose with the same crouch and pitch.
+	*
+	* @param Character	Character to find pose for.
+	* @returns pose or NULL if nothing was recorded for that state
+	*/
+	const FShooterHitboxPose* FindPose(const AShooterCharacter* Character) const;
+
+	/**
+	* Average evaluated bone transforms into the entry matching character state.
+	*
+	* @param Character		Character the pose was evaluated for.
+	* @param InBoneNames		Bones of the pose, table is reset if they don't match.
+	* @param InBoneTransforms	Component space bone transforms.
+	*/
+	void RecordPose(const AShooterCharacter* Character, const TArray<FName>& InBoneNames, const TArray<FTransform>& InBoneTransforms);
+
+protected:
+
+	/** get movement state bucket for character */
+	static EHitboxMoveState::Type GetMoveState(const AShooterCharacter* Character);
+
+	/** get table index for state */
+	int32 GetPoseIndex(EHitboxMoveState::Type MoveState, bool bCrouched, int32 PitchBucket, int32 YawBucket) const;
+
+	/** get table index for character, also returns pitch bucket for fallbacks */
+	int32 GetPoseIndex(const AShooterCharacter* Character, int32& OutPitchBucket) const;
+
+	/** get number of entries in the table */
+	int32 GetNumPoses() const;
+};
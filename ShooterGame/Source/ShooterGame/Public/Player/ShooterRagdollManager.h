@@ -0,0 +1,62 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterRagdollManager.generated.h"
+
+class AShooterCharacter;
+
+/** corpse currently simulating */
+struct FShooterRagdoll
+{
+	/** dead pawn */
+	TWeakObjectPtr<AShooterCharacter> Character;
+
+	/** world time simulation started */
+	float StartTime;
+
+	/** how long the body has been slower than the settle speed */
+	float SettledTime;
+};
+
+/**
+ * Caps the number of simultaneously simulating ragdolls.
+ * Near and visible corpses get a slot first, bodies are frozen once they settle to give the slot back.
+ * Deaths that don't get a slot hold the final pose of their death montage.
+ */
+UCLASS()
+class UShooterRagdollManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Ask for a ragdoll slot, may freeze a less important off screen ragdoll to make room.
+	*
+	* @param Character	Dead pawn.
+	* @returns true if the pawn may simulate physics
+	*/
+	static bool RequestRagdoll(AShooterCharacter* Character);
+
+	/** give slot back without freezing, pawn is being reused or destroyed */
+	static void RemoveRagdoll(AShooterCharacter* Character);
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** importance of a corpse, lower is more important */
+	float GetRagdollScore(const AShooterCharacter* Character) const;
+
+	/** simulating ragdolls */
+	TArray<FShooterRagdoll> Ragdolls;
+};
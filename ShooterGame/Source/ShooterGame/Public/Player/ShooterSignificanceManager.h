@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterTypes.h"
+#include "ShooterSignificanceManager.generated.h"
+
+class AShooterCharacter;
+
+/**
+ * [client] Scores remote pawns by distance, screen size and combat activity every frame.
+ * Insignificant pawns tick, animate and play sounds less often; they go back to full rate as soon as they fire or get hit.
+ */
+UCLASS()
+class UShooterSignificanceManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Set tick rates for a significance level.
+	*
+	* @param Character		Pawn to update.
+	* @param Significance	New level.
+	*/
+	static void ApplySignificance(AShooterCharacter* Character, EShooterSignificance::Type Significance);
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** local view used for scoring */
+	struct FSignificanceView
+	{
+		FVector Location;
+		float TanHalfFOV;
+		const AActor* ViewTarget;
+	};
+
+	/** score pawn against local views */
+	EShooterSignificance::Type CalcSignificance(const AShooterCharacter* Character, const TArray<FSignificanceView, TInlineAllocator<4>>& Views) const;
+
+	/** some pawns were throttled, restore them when the feature gets disabled */
+	bool bHasThrottledPawns;
+};
@@ -59,6 +59,47 @@ namespace EShooterPhysMaterialType
 	};
 }
 
+/** how much detail the local player needs for a remote pawn */
+namespace EShooterSignificance
+{
+	enum Type
+	{
+		Full,
+		Reduced,
+		Minimal,
+	};
+}
+
+/** how often the server updates a bot's behavior tree, set by the AI LOD manager */
+namespace EShooterAILOD
+{
+	enum Type
+	{
+		/** fighting, every frame */
+		Engaged,
+		/** close to a human player */
+		NearHumans,
+		/** not fighting and no human around */
+		Idle,
+		/** far from every human player */
+		Far,
+		MAX,
+	};
+}
+
+/** gameplay sound budgets used by the audio manager */
+namespace EShooterSoundCategory
+{
+	enum Type
+	{
+		Weapon,
+		Impact,
+		Explosion,
+		Movement,
+		MAX,
+	};
+}
+
 namespace EShooterDialogType
 {
 	enum Type
@@ -159,4 +200,72 @@ public:
 	FDamageEvent& GetDamageEvent();
 	void SetDamageEvent(const FDamageEvent& DamageEvent);
 	void EnsureReplication();
-};
\ No newline at end of file
+
+	/** sends only the active damage event, quantized, and what clients need to play hits and deaths */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FTakeHitInfo> : public TStructOpsTypeTraitsBase2<FTakeHitInfo>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/** bits used for quantized health, relative to max health */
+#define SHOOTER_PAWN_HEALTH_BITS	10
+#define SHOOTER_PAWN_HEALTH_MAX		((1 << SHOOTER_PAWN_HEALTH_BITS) - 1)
+
+/** bits used for the inventory slot of the equipped weapon, slot 0 means no weapon */
+#define SHOOTER_PAWN_WEAPON_SLOT_BITS	4
+
+/** replicated pawn state packed into a single property */
+USTRUCT()
+struct FShooterPawnRepState
+{
+	GENERATED_USTRUCT_BODY()
+
+	enum EFlags
+	{
+		Flag_Targeting	= 1 << 0,
+		Flag_Running	= 1 << 1,
+		Num_Flags		= 2,
+	};
+
+	/** health as a fraction of max health, rounded up so a living pawn never reads 0 */
+	UPROPERTY()
+	uint16 Health;
+
+	/** EFlags */
+	UPROPERTY()
+	uint8 Flags;
+
+	/** inventory index + 1 of the equipped weapon, 0 if none */
+	UPROPERTY()
+	uint8 WeaponSlot;
+
+	FShooterPawnRepState()
+		: Health(0)
+		, Flags(0)
+		, WeaponSlot(0)
+	{}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** quantize health */
+	static uint16 PackHealth(float Health, float MaxHealth);
+
+	/** restore health */
+	static float UnpackHealth(uint16 PackedHealth, float MaxHealth);
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterPawnRepState> : public TStructOpsTypeTraitsBase2<FShooterPawnRepState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
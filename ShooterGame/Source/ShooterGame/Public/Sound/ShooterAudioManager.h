@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterTypes.h"
+#include "ShooterAudioManager.generated.h"
+
+class USoundBase;
+
+/** one shot sound waiting for the end of frame */
+struct FShooterSoundRequest
+{
+	/** sound to play */
+	TWeakObjectPtr<USoundBase> Sound;
+
+	/** actor the sound belongs to, used by local player sound nodes */
+	TWeakObjectPtr<AActor> OwningActor;
+
+	/** world location */
+	FVector Location;
+
+	/** squared distance to the closest local listener, closer sounds win */
+	float DistanceSq;
+
+	/** budget the sound counts against */
+	EShooterSoundCategory::Type Category;
+
+	/** owner is locally controlled, never merged with other owners */
+	bool bLocal;
+};
+
+/**
+ * Gameplay one shot sounds with a per category voice budget.
+ * Requests are collected during the frame; same sound requests close to each other are merged,
+ * sounds out of hearing range are rejected before an active sound is created,
+ * and the rest is played closest first while the category has free voices.
+ */
+UCLASS()
+class UShooterAudioManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* Queue one shot sound for the end of the frame.
+	*
+	* @param WorldContextObject	Object in the world to play the sound in.
+	* @param Sound				Sound to play.
+	* @param Location			World location.
+	* @param Category			Voice budget the sound counts against.
+	* @param OwningActor		Actor the sound belongs to.
+	*/
+	static void PlaySoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location, EShooterSoundCategory::Type Category, AActor* OwningActor = nullptr);
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+protected:
+
+	/** merge, cull and play queued sounds */
+	void FlushRequests();
+
+	/** forget voices that finished playing */
+	void ExpireVoices();
+
+	/** squared distance from the closest local listener to a location, MAX_flt without listeners */
+	float GetListenerDistanceSq(const FVector& Location) const;
+
+	/** requests from this frame */
+	TArray<FShooterSoundRequest> PendingRequests;
+
+	/** world time each playing voice ends, per category */
+	TArray<float> VoiceEndTimes[EShooterSoundCategory::MAX];
+};
@@ -28,6 +28,15 @@ class USoundNodeLocalPlayer : public USoundNode
 		return LocallyControlledActorCache;
 	}
 
+	/** [game thread] set locally controlled state of an actor, only changes are queued for the audio thread */
+	static void SetLocallyControlled(uint32 ActorID, bool bLocallyControlled);
+
+	/** [game thread] forget about an actor */
+	static void RemoveLocallyControlled(uint32 ActorID);
+
+	/** [game thread] send all changes queued this frame to the audio thread in one command */
+	static void FlushLocallyControlledUpdates();
+
 private:
 
 	static TMap<uint32, bool> LocallyControlledActorCache;
@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "Tests/ShooterTestControllerBase.h"
+#include "ShooterTestControllerBotSoak.generated.h"
+
+/**
+ * Dedicated server bot soak, meant to run with -nullrhi.
+ * Travels to -SoakMap with -SoakBots bots, skips warmup and samples the server once a second for -SoakDuration seconds
+ * after -SoakWarmup seconds of play: frame work time percentiles (without tick rate idle), behavior tree ms, LOS traces, pathfinding ms,
+ * memory and actor counts go to a CSV file. The test fails if any -SoakMax* threshold given on the command line is exceeded.
+ */
+UCLASS()
+class UShooterTestControllerBotSoak : public UShooterTestControllerBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+	virtual void OnPostMapChange(UWorld* World) override;
+
+protected:
+	virtual void OnTick(float TimeDelta) override;
+
+	/** add CSV row for the samples since the last one */
+	void WriteRow(double Now);
+
+	/** write summary, check thresholds and end the test */
+	void FinishSoak();
+
+	/** end the test with an error */
+	void FailSoak(const FString& Reason);
+
+	/** write line to the CSV file */
+	void WriteLine(const FString& Line);
+
+	/** get percentile of unsorted samples */
+	static float GetPercentile(TArray<float> Samples, float Percentile);
+
+	/** get used physical memory in MB */
+	static float GetUsedMemoryMB();
+
+	// Settings
+	FString SoakMap;
+	FString SoakGame;
+	int32 SoakBots;
+	float SoakWarmup;
+	float SoakDuration;
+	FString CsvPath;
+
+	// Thresholds, 0 disables a check
+	float MaxFrameP95Ms;
+	float MaxFrameP99Ms;
+	float MaxAIMs;
+	float MaxMemoryGrowthMB;
+	int32 MaxActors;
+
+	// Progress
+	uint8 bTravelRequested : 1;
+	uint8 bSampling : 1;
+	uint8 bFinished : 1;
+	double PlayStartTime;
+	double LastRowTime;
+	uint32 LastNumTraces;
+
+	// Samples since the last row
+	TArray<float> RowFrameMs;
+	TArray<float> RowGameThreadMs;
+	float RowAIMs;
+
+	// Samples of the whole run
+	TArray<float> AllFrameMs;
+	float TotalAIMs;
+	int32 NumFrames;
+	float StartMemoryMB;
+	float PeakMemoryMB;
+	float LastMemoryMB;
+	int32 PeakActors;
+
+	FArchive* CsvFile;
+};
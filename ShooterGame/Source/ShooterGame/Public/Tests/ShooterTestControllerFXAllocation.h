@@ -0,0 +1,42 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "Tests/ShooterTestControllerBase.h"
+#include "ShooterTestControllerFXAllocation.generated.h"
+
+class AShooterCharacter;
+
+/**
+ * Weapon effect pool check, meant to run as a rendering client that hosts its own match.
+ * Hosts -FXMap without bots, keeps the local player firing with infinite ammo and fails if
+ * AShooterWeapon::NumFXComponentsAllocated grows during the -FXDuration seconds that follow -FXWarmup seconds of firing.
+ */
+UCLASS()
+class UShooterTestControllerFXAllocation : public UShooterTestControllerBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+	virtual void OnPostMapChange(UWorld* World) override {}
+
+protected:
+	virtual void OnTick(float TimeDelta) override;
+	virtual void OnUserCanPlayOnline(const FUniqueNetId& UserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResults) override;
+	virtual void HostGame() override;
+
+	/** end the test once */
+	void FinishTest(int32 ExitCode);
+
+	// Settings
+	FString FXMap;
+	float FXWarmup;
+	float FXDuration;
+
+	// Progress
+	uint8 bFinished : 1;
+	uint8 bSampling : 1;
+	TWeakObjectPtr<AShooterCharacter> FiringPawn;
+	double FireStartTime;
+	int32 BaselineAllocated;
+};
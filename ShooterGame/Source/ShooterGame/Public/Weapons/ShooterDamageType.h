@@ -5,7 +5,7 @@
 #include "ShooterDamageType.generated.h"
 
 // DamageType class that specifies an icon to display
-UCLASS(const, Blueprintable, BlueprintType)
+UCLASS(const, Blueprintable, BlueprintType, config=Game)
 class UShooterDamageType : public UDamageType
 {
 	GENERATED_UCLASS_BODY()
@@ -21,6 +21,16 @@ class UShooterDamageType : public UDamageType
 	/** force feedback effect to play on a player killed by this damage type */
 	UPROPERTY(EditDefaultsOnly, Category=Effects)
 	UForceFeedbackEffect *KilledForceFeedback;
+
+	/** damage types replicated as a small index in FTakeHitInfo, others are sent as object references */
+	UPROPERTY(config)
+	TArray<FSoftClassPath> NetDamageTypes;
+
+	/** get index of damage type in NetDamageTypes, INDEX_NONE if it isn't listed */
+	static int32 GetNetDamageTypeIndex(const UClass* DamageTypeClass);
+
+	/** get damage type listed in NetDamageTypes, NULL if index is invalid or the class isn't loaded */
+	static UClass* GetNetDamageType(int32 Index);
 };
 
 
@@ -321,6 +321,24 @@ protected:
 	UPROPERTY(Transient)
 	UParticleSystemComponent* MuzzlePSCSecondary;
 
+	/** number of muzzle FX components kept per weapon mesh, reused oldest first */
+	UPROPERTY(EditDefaultsOnly, Category=Effects)
+	int32 MuzzleFXPoolSize;
+
+	/** preallocated muzzle FX components on 1st person mesh */
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> MuzzlePool1P;
+
+	/** preallocated muzzle FX components on 3rd person mesh */
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> MuzzlePool3P;
+
+	/** next component to reuse from MuzzlePool1P */
+	int32 NextMuzzle1P;
+
+	/** next component to reuse from MuzzlePool3P */
+	int32 NextMuzzle3P;
+
 	/** camera shake on firing */
 	UPROPERTY(EditDefaultsOnly, Category=Effects)
 	TSubclassOf<UMatineeCameraShake> FireCameraShake;
@@ -536,6 +554,39 @@ protected:
 	/** find hit */
 	FHitResult WeaponTrace(const FVector& TraceFrom, const FVector& TraceTo) const;
 
+	/**
+	* Get effect component from a pool owned by this weapon, allocating it only until the pool is full.
+	* Returned component is not activated.
+	*
+	* @param Pool			Components owned by the weapon.
+	* @param NextIndex		Ring position of the oldest component.
+	* @param PoolSize		Max number of components in the pool.
+	* @param Template		Particle system to play.
+	* @param AttachParent	Component to attach to, NULL for world space effects.
+	* @param AttachPoint	Socket on AttachParent.
+	*/
+	UParticleSystemComponent* GetPooledFX(TArray<UParticleSystemComponent*>& Pool, int32& NextIndex, int32 PoolSize, UParticleSystem* Template, USceneComponent* AttachParent, FName AttachPoint);
+
+	/**
+	* Count an effect against a budget shared by all weapons, returns false when it's used up for this frame.
+	*
+	* @param BudgetFrame		Frame the budget was last reset.
+	* @param SpawnedThisFrame	Effects played this frame.
+	* @param MaxPerFrame		Budget, 0 or less is unlimited.
+	*/
+	static bool ConsumeFXFrameBudget(uint64& BudgetFrame, int32& SpawnedThisFrame, int32 MaxPerFrame);
+
+	/**
+	* [server] find closest pawn hit using simplified hitboxes.
+	* Pawns that were tested are added to TraceParams ignore list, so the world trace only needs to check geometry.
+	*
+	* @param TraceFrom		Trace start.
+	* @param TraceTo		Trace end.
+	* @param TraceParams	Query params for the following world trace.
+	* @param OutHit			Closest pawn hit.
+	*/
+	bool HitboxTrace(const FVector& TraceFrom, const FVector& TraceTo, FCollisionQueryParams& TraceParams, FHitResult& OutHit) const;
+
 protected:
 	/** Returns Mesh1P subobject **/
 	FORCEINLINE USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
@@ -546,5 +597,8 @@ public:
 
 	UPROPERTY(EditDefaultsOnly)
 		TSubclassOf<AShooterPickup_Ammo> ammoDropType;
+
+	/** number of effect components allocated by weapons, stays flat once the pools are filled */
+	static int32 NumFXComponentsAllocated;
 };
 
@@ -117,6 +117,17 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category=Effects)
 	FName TrailTargetParam;
 
+	/** number of smoke trail components kept by the weapon, reused oldest first */
+	UPROPERTY(EditDefaultsOnly, Category=Effects)
+	int32 TrailFXPoolSize;
+
+	/** preallocated smoke trail components */
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> TrailPool;
+
+	/** next component to reuse from TrailPool */
+	int32 NextTrail;
+
 	/** instant hit notify for replication */
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_HitNotify)
 	FInstantHitInfo HitNotify;